@@ -0,0 +1,112 @@
+#include "AnalysisPanel.h"
+#include "EngineBudget.h"
+
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QSpinBox>
+#include <QStringList>
+#include <QVBoxLayout>
+
+#include <cstdlib>
+
+AnalysisPanel::AnalysisPanel(QWidget *parent)
+        : QWidget(parent), m_engine(EngineBudget::threadsPerEngine(), EngineBudget::hashPerEngine()) {
+    m_toggle = new QCheckBox("Analyse", this);
+    m_linesBox = new QSpinBox(this);
+    m_linesBox->setRange(1, 8);
+    m_linesBox->setSuffix(" lines");
+    m_depthLabel = new QLabel(this);
+    m_scoreLabel = new QLabel(this);
+    m_speedLabel = new QLabel(this);
+    m_pvLabel = new QLabel(this);
+    m_pvLabel->setWordWrap(true);
+    m_pvLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QHBoxLayout *toggleLayout = new QHBoxLayout;
+    toggleLayout->addWidget(m_toggle);
+    toggleLayout->addWidget(m_linesBox);
+    layout->addLayout(toggleLayout);
+    layout->addWidget(m_depthLabel);
+    layout->addWidget(m_scoreLabel);
+    layout->addWidget(m_speedLabel);
+    layout->addWidget(m_pvLabel, 1);
+    setFixedWidth(220);
+
+    connect(m_toggle, &QCheckBox::toggled, this, &AnalysisPanel::setAnalysing);
+    connect(m_linesBox, &QSpinBox::valueChanged, this, [this] { if (m_analysing) restart(); });
+
+    // Called on the engine's main search thread; hop over to the GUI thread
+    m_engine.setInfoCallback([this](const SearchInfo &info) {
+        QMetaObject::invokeMethod(this, [this, info] { showInfo(info); }, Qt::QueuedConnection);
+    });
+}
+
+AnalysisPanel::~AnalysisPanel() {
+    m_engine.stop();
+}
+
+void AnalysisPanel::setPosition(const Position &position) {
+    m_position = position;
+    if (m_analysing) restart();
+}
+
+void AnalysisPanel::setAnalysing(bool analysing) {
+    if (analysing == m_analysing) return;
+    m_analysing = analysing;
+    m_toggle->setChecked(analysing);
+    if (analysing) {
+        restart();
+    } else {
+        m_engine.stop();
+        m_searchId = 0;
+        emit bestMovesChanged({});
+    }
+}
+
+void AnalysisPanel::restart() {
+    m_depthLabel->clear();
+    m_scoreLabel->clear();
+    m_speedLabel->clear();
+    m_pvLabel->clear();
+    emit bestMovesChanged({});
+
+    SearchLimits limits;
+    limits.infinite = true;
+    limits.multiPV = m_linesBox->value();
+    m_searchId = m_engine.go(m_position, limits);
+}
+
+void AnalysisPanel::showInfo(const SearchInfo &info) {
+    // Iterations of a search that has since been restarted or stopped
+    if (info.searchId != m_searchId) return;
+
+    if (info.lines.empty()) return;
+
+    QStringList lines;
+    QList<MoveMark> marks;
+    for (const PvLine &line : info.lines) {
+        QStringList pv;
+        for (Move move : line.pv) pv << QString::fromStdString(moveToUci(move));
+        lines << formatScore(line.score) + "  " + pv.join(' ');
+        marks.append({line.pv.front(), formatScore(line.score)});
+    }
+
+    m_depthLabel->setText(QString("Depth %1/%2").arg(info.depth).arg(info.selDepth));
+    m_scoreLabel->setText("Score " + formatScore(info.lines.front().score));
+    m_speedLabel->setText(QString("%1 kN/s, %2 kN").arg(info.nps / 1000).arg(info.nodes / 1000));
+    m_pvLabel->setText(lines.join('\n'));
+    emit bestMovesChanged(marks);
+}
+
+// Scores are shown from White's point of view, mates as #n
+QString AnalysisPanel::formatScore(int score) const {
+    if (m_position.sideToMove() == Black) score = -score;
+
+    if (std::abs(score) >= MateInMaxPly) {
+        int movesToMate = (MateScore - std::abs(score) + 1) / 2;
+        return QString(score > 0 ? "#%1" : "-#%1").arg(movesToMate);
+    }
+    return QString::asprintf("%+.2f", score / 100.0);
+}
@@ -0,0 +1,49 @@
+#ifndef CHESS_ANALYSISPANEL_H
+#define CHESS_ANALYSISPANEL_H
+
+#include <QWidget>
+
+#include "ChessBoard.h"
+#include "Search.h"
+
+class QCheckBox;
+class QLabel;
+class QSpinBox;
+
+// Side panel that analyses the board position on background threads. Search results
+// arrive through queued calls, so the GUI thread never waits on the engine.
+class AnalysisPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit AnalysisPanel(QWidget *parent = nullptr);
+    ~AnalysisPanel() override;
+
+public slots:
+    // Restarts the analysis on the new position if analysis is on
+    void setPosition(const Position &position);
+    void setAnalysing(bool analysing);
+
+signals:
+    // First move of each MultiPV line with its score, best first; empty when analysis stops
+    void bestMovesChanged(const QList<MoveMark> &marks);
+
+private:
+    void restart();
+    void showInfo(const SearchInfo &info);
+    QString formatScore(int score) const;
+
+    Engine m_engine;
+    Position m_position;
+    std::uint64_t m_searchId = 0;
+    bool m_analysing = false;
+
+    QCheckBox *m_toggle;
+    QSpinBox *m_linesBox;
+    QLabel *m_depthLabel;
+    QLabel *m_scoreLabel;
+    QLabel *m_speedLabel;
+    QLabel *m_pvLabel;
+};
+
+#endif //CHESS_ANALYSISPANEL_H
@@ -0,0 +1,64 @@
+#include "Bitboard.h"
+
+Bitboard PawnAttacks[2][64];
+Bitboard KnightAttacks[64];
+Bitboard KingAttacks[64];
+Bitboard RayAttacks[8][64];
+Bitboard BetweenBB[64][64];
+Bitboard LineBB[64][64];
+
+namespace {
+    const int RowSteps[8] = {1, 0, 1, 1, -1, 0, -1, -1};
+    const int ColSteps[8] = {0, 1, 1, -1, 0, -1, -1, 1};
+
+    bool onBoard(int row, int col) {
+        return row >= 0 && row < 8 && col >= 0 && col < 8;
+    }
+
+    // Squares reachable from s by the given (row, col) offsets, ignoring blockers
+    Bitboard stepAttacks(Square s, const int (*offsets)[2], int count) {
+        Bitboard attacks = 0;
+        for (int i = 0; i < count; ++i) {
+            int row = rowOf(s) + offsets[i][0];
+            int col = colOf(s) + offsets[i][1];
+            if (onBoard(row, col)) attacks |= squareBB(makeSquare(row, col));
+        }
+        return attacks;
+    }
+}
+
+void Bitboards::init() {
+    const int knightOffsets[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
+    const int kingOffsets[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    const int whitePawnOffsets[2][2] = {{1, 1}, {1, -1}};
+    const int blackPawnOffsets[2][2] = {{-1, 1}, {-1, -1}};
+
+    for (Square s = 0; s < 64; ++s) {
+        KnightAttacks[s] = stepAttacks(s, knightOffsets, 8);
+        KingAttacks[s] = stepAttacks(s, kingOffsets, 8);
+        PawnAttacks[White][s] = stepAttacks(s, whitePawnOffsets, 2);
+        PawnAttacks[Black][s] = stepAttacks(s, blackPawnOffsets, 2);
+
+        for (int d = 0; d < 8; ++d) {
+            Bitboard ray = 0;
+            for (int row = rowOf(s) + RowSteps[d], col = colOf(s) + ColSteps[d]; onBoard(row, col);
+                 row += RowSteps[d], col += ColSteps[d]) {
+                ray |= squareBB(makeSquare(row, col));
+            }
+            RayAttacks[d][s] = ray;
+        }
+    }
+
+    for (Square a = 0; a < 64; ++a) {
+        for (Square b = 0; b < 64; ++b) {
+            BetweenBB[a][b] = LineBB[a][b] = 0;
+            for (int d = 0; d < 8; ++d) {
+                if (RayAttacks[d][a] & squareBB(b)) {
+                    int opposite = (d + 4) % 8;
+                    BetweenBB[a][b] = RayAttacks[d][a] & RayAttacks[opposite][b];
+                    LineBB[a][b] = RayAttacks[d][a] | RayAttacks[opposite][a] | squareBB(a);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef CHESS_BITBOARD_H
+#define CHESS_BITBOARD_H
+
+#include "Types.h"
+
+#include <bit>
+
+enum Direction { North, East, NorthEast, NorthWest, South, West, SouthWest, SouthEast };
+
+namespace Bitboards {
+    // Fills the attack and line tables below; must run once before any Position is used
+    void init();
+}
+
+extern Bitboard PawnAttacks[2][64];
+extern Bitboard KnightAttacks[64];
+extern Bitboard KingAttacks[64];
+extern Bitboard RayAttacks[8][64];
+extern Bitboard BetweenBB[64][64]; // Squares strictly between two aligned squares
+extern Bitboard LineBB[64][64];    // Whole line through two aligned squares, empty if not aligned
+
+constexpr Bitboard squareBB(Square s) { return Bitboard(1) << s; }
+
+inline int popcount(Bitboard b) { return std::popcount(b); }
+inline Square lsb(Bitboard b) { return std::countr_zero(b); }
+inline Square msb(Bitboard b) { return 63 - std::countl_zero(b); }
+
+inline Square popLsb(Bitboard &b) {
+    Square s = lsb(b);
+    b &= b - 1;
+    return s;
+}
+
+// Classical ray lookup: cut the ray at the first blocker. Directions before South
+// increase the square index, so their nearest blocker is the lowest set bit.
+inline Bitboard slidingAttacks(Direction d, Square s, Bitboard occupied) {
+    Bitboard ray = RayAttacks[d][s];
+    Bitboard blockers = ray & occupied;
+    if (blockers) {
+        ray ^= RayAttacks[d][d < South ? lsb(blockers) : msb(blockers)];
+    }
+    return ray;
+}
+
+inline Bitboard rookAttacks(Square s, Bitboard occupied) {
+    return slidingAttacks(North, s, occupied) | slidingAttacks(East, s, occupied)
+         | slidingAttacks(South, s, occupied) | slidingAttacks(West, s, occupied);
+}
+
+inline Bitboard bishopAttacks(Square s, Bitboard occupied) {
+    return slidingAttacks(NorthEast, s, occupied) | slidingAttacks(NorthWest, s, occupied)
+         | slidingAttacks(SouthEast, s, occupied) | slidingAttacks(SouthWest, s, occupied);
+}
+
+#endif //CHESS_BITBOARD_H
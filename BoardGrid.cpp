@@ -0,0 +1,109 @@
+#include "BoardGrid.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+#include <QTimer>
+
+#include "BoardItem.h"
+#include "PieceAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int CellMargin = 4;
+}
+
+BoardGrid::BoardGrid(int boards, QWidget *parent)
+        : QWidget(parent), m_pending(boards), m_dirty(boards, false) {
+    // Every board starts from the initial position until its game posts something else
+    PieceBoards start;
+    Position startPosition;
+    for (int p = 0; p < 2 * PieceTypeCount; ++p) {
+        start[p] = startPosition.pieces(colorOf(Piece(p)), typeOf(Piece(p)));
+    }
+    m_shown.assign(boards, start);
+
+    // Every pixel is painted, so Qt need not clear the background first
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumSize(400, 400);
+
+    // One timer for all boards: a frame collects whatever the game threads posted since
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &BoardGrid::flush);
+    m_frameTimer->start(16);
+}
+
+void BoardGrid::setPosition(int board, const Position &position) {
+    PieceBoards pieces;
+    for (int p = 0; p < 2 * PieceTypeCount; ++p) {
+        pieces[p] = position.pieces(colorOf(Piece(p)), typeOf(Piece(p)));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending[board] = pieces;
+    m_dirty[board] = true;
+    m_anyDirty.store(true, std::memory_order_release);
+}
+
+void BoardGrid::flush() {
+    // Most frames nothing moved; don't take the lock for them
+    if (!m_anyDirty.exchange(false, std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int board = 0; board < boardCount(); ++board) {
+        if (!m_dirty[board]) continue;
+        m_dirty[board] = false;
+
+        Bitboard changed = 0;
+        for (int p = 0; p < 2 * PieceTypeCount; ++p) changed |= m_shown[board][p] ^ m_pending[board][p];
+        m_shown[board] = m_pending[board];
+
+        // Qt merges these into one region and paints it in the next frame
+        while (changed) update(squareRect(board, popLsb(changed)).toAlignedRect());
+    }
+}
+
+// Boards fill the widget in a near-square grid, each scaled to fit its cell
+QRectF BoardGrid::boardRect(int board) const {
+    int columns = int(std::ceil(std::sqrt(double(boardCount()))));
+    int rows = (boardCount() + columns - 1) / columns;
+    double cell = std::min(double(width()) / columns, double(height()) / rows);
+    return QRectF((board % columns) * cell + CellMargin, (board / columns) * cell + CellMargin,
+                  cell - 2 * CellMargin, cell - 2 * CellMargin);
+}
+
+QRectF BoardGrid::squareRect(int board, Square s) const {
+    QRectF rect = boardRect(board);
+    double size = rect.width() / 8;
+    return QRectF(rect.x() + colOf(s) * size, rect.y() + rowOf(s) * size, size, size);
+}
+
+void BoardGrid::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    painter.fillRect(event->rect(), Qt::gray);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // Glyphs at the screen's ratio stay sharp on high-density screens; a no-op once it matches
+    PieceAtlas::setDevicePixelRatio(devicePixelRatioF());
+    const QPixmap &background = BoardItem::background(devicePixelRatioF());
+    const double scale = boardRect(0).width() / (8 * BoardItem::SquareSize);
+    for (int board = 0; board < boardCount(); ++board) {
+        QRectF rect = boardRect(board);
+        if (!rect.intersects(QRectF(event->rect()))) continue;
+
+        // Paint in the board's own 400 by 400 coordinates, like the full-size board
+        painter.save();
+        painter.translate(rect.topLeft());
+        painter.scale(scale, scale);
+        painter.drawPixmap(QPointF(0, 0), background);
+        for (int p = 0; p < 2 * PieceTypeCount; ++p) {
+            const QPixmap &glyph = PieceAtlas::glyph(typeOf(Piece(p)), colorOf(Piece(p)) == White);
+            for (Bitboard squares = m_shown[board][p]; squares;) {
+                painter.drawPixmap(BoardItem::squareRect(popLsb(squares)).topLeft(), glyph);
+            }
+        }
+        painter.restore();
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef CHESS_BOARDGRID_H
+#define CHESS_BOARDGRID_H
+
+#include <QWidget>
+
+#include "Position.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+class QTimer;
+
+// Many small boards in one widget, for showing concurrent games side by side. Boards paint
+// from the shared background pixmap and glyph atlas with no scene or items behind them.
+// Positions may be posted from any thread; the grid picks up the latest of each board
+// once per frame and repaints only the squares that changed.
+class BoardGrid : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit BoardGrid(int boards, QWidget *parent = nullptr);
+
+    int boardCount() const { return int(m_shown.size()); }
+
+    // Thread-safe. Several positions posted within one frame show only the last.
+    void setPosition(int board, const Position &position);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    // The piece bitboards of a position, indexed by Piece: all a board needs to paint
+    using PieceBoards = std::array<Bitboard, 2 * PieceTypeCount>;
+
+    void flush();
+    QRectF boardRect(int board) const;
+    QRectF squareRect(int board, Square s) const;
+
+    std::mutex m_mutex;
+    std::vector<PieceBoards> m_pending; // Guarded by m_mutex
+    std::vector<bool> m_dirty;          // Guarded by m_mutex
+    std::atomic<bool> m_anyDirty{false};
+
+    std::vector<PieceBoards> m_shown;   // GUI thread only
+    QTimer *m_frameTimer;
+};
+
+#endif //CHESS_BOARDGRID_H
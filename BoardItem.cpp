@@ -0,0 +1,110 @@
+#include "BoardItem.h"
+
+#include <QCoreApplication>
+#include <QFont>
+#include <QPainter>
+#include <QPen>
+#include <QStyleOptionGraphicsItem>
+
+namespace {
+    constexpr int BoardSize = 8 * BoardItem::SquareSize;
+
+    QPixmap backgroundPixmap;
+
+    // Released from the application's destructor, like the piece atlas
+    void releaseBackground() {
+        backgroundPixmap = QPixmap();
+    }
+}
+
+const QPixmap &BoardItem::background(qreal ratio) {
+    if (!backgroundPixmap.isNull() && backgroundPixmap.devicePixelRatio() == ratio) return backgroundPixmap;
+    if (backgroundPixmap.isNull()) qAddPostRoutine(releaseBackground);
+
+    backgroundPixmap = QPixmap(QSize(BoardSize, BoardSize) * ratio);
+    backgroundPixmap.setDevicePixelRatio(ratio);
+
+    QPainter painter(&backgroundPixmap);
+    painter.setFont(QFont("Arial", 7));
+    for (Square s = 0; s < 64; ++s) {
+        bool light = (rowOf(s) + colOf(s)) % 2 == 0;
+        QRectF rect = BoardItem::squareRect(s);
+        painter.fillRect(rect, light ? Qt::lightGray : Qt::darkGray);
+
+        // Ranks down the left edge, files along the bottom (White sits at the top)
+        painter.setPen(light ? Qt::darkGray : Qt::lightGray);
+        QRectF label = rect.adjusted(2, 1, -2, -1);
+        if (colOf(s) == 0) painter.drawText(label, Qt::AlignLeft | Qt::AlignTop, QString::number(rowOf(s) + 1));
+        if (rowOf(s) == 7) painter.drawText(label, Qt::AlignRight | Qt::AlignBottom, QString(QChar('a' + colOf(s))));
+    }
+    return backgroundPixmap;
+}
+
+BoardItem::BoardItem() {
+    setZValue(-2);
+    setAcceptedMouseButtons(Qt::NoButton);
+    // Gives paint() the exposed rect, so a repaint blits only the dirty part
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+QRectF BoardItem::boundingRect() const {
+    return QRectF(0, 0, BoardSize, BoardSize);
+}
+
+void BoardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) {
+    qreal ratio = painter->device()->devicePixelRatioF();
+    QRectF exposed = option->exposedRect.intersected(boundingRect());
+    painter->drawPixmap(exposed, background(ratio),
+                        QRectF(exposed.x() * ratio, exposed.y() * ratio, exposed.width() * ratio, exposed.height() * ratio));
+
+    painter->setFont(QFont("Arial", 8));
+    for (const SquareMark &mark : m_marks) {
+        QRectF rect = squareRect(mark.square);
+        if (!rect.intersects(exposed)) continue;
+
+        QColor color = mark.color;
+        color.setAlphaF(0.6);
+        painter->fillRect(rect, color);
+        if (!mark.caption.isEmpty()) {
+            painter->setPen(Qt::black);
+            painter->drawText(rect.adjusted(2, 36, 0, 0), Qt::AlignLeft | Qt::AlignTop, mark.caption);
+        }
+    }
+
+    QColor highlight(Qt::blue);
+    highlight.setAlphaF(0.5);
+    for (Bitboard squares = m_highlights; squares;) {
+        QRectF rect = squareRect(popLsb(squares));
+        if (rect.intersects(exposed)) painter->fillRect(rect, highlight);
+    }
+
+    if (m_hoverSquare >= 0 && squareRect(m_hoverSquare).intersects(exposed)) {
+        painter->setPen(QPen(Qt::yellow, 3));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(squareRect(m_hoverSquare).adjusted(1.5, 1.5, -1.5, -1.5));
+    }
+}
+
+void BoardItem::setHighlights(Bitboard squares) {
+    updateSquares(m_highlights ^ squares);
+    m_highlights = squares;
+}
+
+void BoardItem::setMarks(std::vector<SquareMark> marks) {
+    Bitboard changed = 0;
+    for (const SquareMark &mark : m_marks) changed |= squareBB(mark.square);
+    for (const SquareMark &mark : marks) changed |= squareBB(mark.square);
+    m_marks = std::move(marks);
+    updateSquares(changed);
+}
+
+void BoardItem::setHoverSquare(int square) {
+    if (square == m_hoverSquare) return;
+    if (m_hoverSquare >= 0) update(squareRect(m_hoverSquare));
+    if (square >= 0) update(squareRect(square));
+    m_hoverSquare = square;
+}
+
+void BoardItem::updateSquares(Bitboard squares) {
+    while (squares) update(squareRect(popLsb(squares)));
+}
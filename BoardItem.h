@@ -0,0 +1,55 @@
+#ifndef CHESS_BOARDITEM_H
+#define CHESS_BOARDITEM_H
+
+#include <QColor>
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QString>
+
+#include "Bitboard.h"
+
+#include <vector>
+
+// A square tinted on the board, with an optional caption in its lower-left corner
+struct SquareMark {
+    Square square;
+    QColor color;
+    QString caption;
+};
+
+// The whole board as one item: squares, coordinates, move highlights and marks are
+// painted in a single pass over a cached background pixmap, so the scene holds one item
+// for the board instead of one per square. It sits below the pieces and takes no clicks.
+class BoardItem : public QGraphicsItem {
+public:
+    static constexpr int SquareSize = 50;
+
+    BoardItem();
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+    // Squares a selected piece can move to; 0 clears them
+    void setHighlights(Bitboard squares);
+    // Replaces the marks; only squares whose marks changed are repainted
+    void setMarks(std::vector<SquareMark> marks);
+    // Outlines the square a dragged piece would drop on; -1 clears it
+    void setHoverSquare(int square);
+
+    // Squares and coordinates of an empty board, rendered once per pixel ratio and shared
+    // by every board on screen
+    static const QPixmap &background(qreal ratio);
+
+    static QRectF squareRect(Square s) {
+        return QRectF(colOf(s) * SquareSize, rowOf(s) * SquareSize, SquareSize, SquareSize);
+    }
+
+private:
+    void updateSquares(Bitboard squares);
+
+    Bitboard m_highlights = 0;
+    int m_hoverSquare = -1;
+    std::vector<SquareMark> m_marks;
+};
+
+#endif //CHESS_BOARDITEM_H
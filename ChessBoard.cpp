@@ -0,0 +1,551 @@
+#include "ChessBoard.h"
+#include "Trace.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QStringList>
+#include <QPainter>
+#include <QShowEvent>
+
+#ifdef CHESS_OPENGL
+#include <QGuiApplication>
+#include <QOpenGLWidget>
+#include <QSurfaceFormat>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+    // Viewport area covered by the frame-time HUD
+    const QRect HudRect(0, 0, 250, 46);
+}
+
+void ChessBoard::highlightValidMoves(ChessPiece *piece, bool highlight) {
+    if (!piece) return;
+    boardItem->setHighlights(highlight ? targetsFrom(squareOf(piece)) : 0);
+}
+
+Square ChessBoard::squareOf(const ChessPiece *piece) const {
+    return Square(std::find(std::begin(squarePieces), std::end(squarePieces), piece) - std::begin(squarePieces));
+}
+
+Bitboard ChessBoard::targetsFrom(Square from) const {
+    Bitboard targets = 0;
+    for (const Move &move : legalMoves) {
+        if (move.from() == from) targets |= squareBB(move.to());
+    }
+    return targets;
+}
+
+void ChessBoard::setMoveMarks(const QList<MoveMark> &marks) {
+    std::vector<SquareMark> squareMarks;
+    Bitboard marked = 0;
+    for (int i = 0; i < marks.size(); ++i) {
+        // Several lines can end on the same square; the better one keeps it
+        Square to = marks[i].move.to();
+        if (marked & squareBB(to)) continue;
+        marked |= squareBB(to);
+
+        // Green for the best line, fading to yellow down the list
+        int hue = 120 - 60 * i / std::max<int>(marks.size() - 1, 1);
+        squareMarks.push_back({to, QColor::fromHsv(hue, 200, 230), marks[i].caption});
+    }
+    boardItem->setMarks(std::move(squareMarks));
+}
+
+void ChessBoard::mousePressEvent(QMouseEvent *event) {
+    Trace::Scope scope("mouse press");
+    QElapsedTimer latency;
+    latency.start();
+    QGraphicsView::mousePressEvent(event);
+    if (!interactiveSides[position.sideToMove()]) return;
+    animator->finish();
+
+    QPoint viewportPos = event->pos();
+    QPointF scenePos = mapToScene(viewportPos);
+    emit pressed(scenePos);
+
+    int row = static_cast<int>(scenePos.y() / 50);
+    int col = static_cast<int>(scenePos.x() / 50);
+
+    if (row < 0 || row > 7 || col < 0 || col > 7) return;
+    ChessPiece *clickedPiece = pieceAt(row, col);
+    ChessPiece *previouslySelected = selectedPiece;
+
+    const bool isWhiteTurn = position.sideToMove() == White;
+    if (isWhiteTurn) {
+        // White's turn
+        if (selectedPiece == nullptr && clickedPiece != nullptr && clickedPiece->isWhitePiece()) {
+            selectedPiece = clickedPiece;
+            originalPos = clickedPiece->pos();
+            highlightValidMoves(selectedPiece);
+            selectedPiece->highlight();
+        } else if (selectedPiece != nullptr && (clickedPiece == nullptr || isValidMove(selectedPiece, row, col))) {
+            if (moveByHand(selectedPiece, row, col)) {
+                selectedPiece->highlight(false);
+                selectedPiece = nullptr;
+                clearHighlights();
+            } else {
+                // Handle invalid move
+            }
+        } else if (selectedPiece != nullptr && clickedPiece == selectedPiece) {
+            selectedPiece->highlight(false);
+            selectedPiece = nullptr;
+            clearHighlights();
+        } else if (selectedPiece != nullptr && clickedPiece != selectedPiece) {
+            // Handle trying to move opponent's piece
+        } else {
+            // Handle other cases
+        }
+    } else {
+        // Black's turn
+        if (selectedPiece == nullptr && clickedPiece != nullptr && !clickedPiece->isWhitePiece()) {
+            selectedPiece = clickedPiece;
+            originalPos = clickedPiece->pos();
+            highlightValidMoves(selectedPiece);
+            selectedPiece->highlight();
+        } else if (selectedPiece != nullptr && (clickedPiece == nullptr || isValidMove(selectedPiece, row, col))) {
+            if (moveByHand(selectedPiece, row, col)) {
+                selectedPiece->highlight(false);
+                selectedPiece = nullptr;
+                clearHighlights();
+            } else {
+                // Handle invalid move
+            }
+        } else if (selectedPiece != nullptr && clickedPiece == selectedPiece) {
+            selectedPiece->highlight(false);
+            selectedPiece = nullptr;
+            clearHighlights();
+        } else if (selectedPiece != nullptr && clickedPiece != selectedPiece) {
+            // Handle trying to move opponent's piece
+        } else {
+            // Handle other cases
+        }
+    }
+
+    if (selectedPiece && selectedPiece != previouslySelected) clickHistogram.record(latency.nsecsElapsed());
+
+    // A press that selected a piece may turn into a drag
+    if (selectedPiece && selectedPiece == clickedPiece) {
+        draggedPiece = selectedPiece;
+        dragTargets = targetsFrom(squareOf(selectedPiece));
+        dragOffset = scenePos - selectedPiece->pos();
+        pressPos = viewportPos;
+        dragMoved = false;
+    }
+}
+
+void ChessBoard::mouseMoveEvent(QMouseEvent *event) {
+    if (!draggedPiece) {
+        QGraphicsView::mouseMoveEvent(event);
+        return;
+    }
+
+    // Small jitters during a click don't count as dragging
+    if (!dragMoved) {
+        if ((event->pos() - pressPos).manhattanLength() < QApplication::startDragDistance()) return;
+        dragMoved = true;
+        draggedPiece->setZValue(1);
+    }
+
+    QPointF scenePos = mapToScene(event->pos());
+    draggedPiece->setPos(scenePos - dragOffset);
+
+    int row = static_cast<int>(std::floor(scenePos.y() / 50));
+    int col = static_cast<int>(std::floor(scenePos.x() / 50));
+    bool onTarget = row >= 0 && row < 8 && col >= 0 && col < 8 && (dragTargets & squareBB(makeSquare(row, col)));
+    boardItem->setHoverSquare(onTarget ? makeSquare(row, col) : -1);
+}
+
+void ChessBoard::mouseReleaseEvent(QMouseEvent *event) {
+    if (!draggedPiece) {
+        QGraphicsView::mouseReleaseEvent(event);
+        return;
+    }
+
+    ChessPiece *piece = draggedPiece;
+    draggedPiece = nullptr;
+    boardItem->setHoverSquare(-1);
+    // Without a drag this was a click, and the piece stays selected for a second one
+    if (!dragMoved) return;
+    piece->setZValue(0);
+
+    QPointF scenePos = mapToScene(event->pos());
+    int row = static_cast<int>(std::floor(scenePos.y() / 50));
+    int col = static_cast<int>(std::floor(scenePos.x() / 50));
+    bool onTarget = row >= 0 && row < 8 && col >= 0 && col < 8 && (dragTargets & squareBB(makeSquare(row, col)));
+    if (onTarget && moveByHand(piece, row, col)) {
+        piece->highlight(false);
+        selectedPiece = nullptr;
+        clearHighlights();
+        return;
+    }
+
+    // Dropped off target: back where it came from, still selected
+    piece->setPos(originalPos);
+}
+
+void ChessBoard::cancelDrag() {
+    if (!draggedPiece) return;
+    if (dragMoved) {
+        draggedPiece->setZValue(0);
+        draggedPiece->setPos(originalPos);
+    }
+    draggedPiece = nullptr;
+    boardItem->setHoverSquare(-1);
+}
+
+void ChessBoard::showEvent(QShowEvent *event) {
+    QGraphicsView::showEvent(event);
+    if (!PieceAtlas::setDevicePixelRatio(devicePixelRatioF())) return;
+
+    for (ChessPiece *piece : squarePieces) {
+        if (piece) piece->refreshGlyph();
+    }
+    for (ChessPiece *piece : parkedPieces) piece->refreshGlyph();
+}
+
+void ChessBoard::setupViewport() {
+    // The background brush is cached, and with a few dozen mostly still items a linear scan
+    // beats keeping a BSP tree up to date as pieces move
+    setCacheMode(QGraphicsView::CacheBackground);
+    setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing);
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+    scene->setSceneRect(0, 0, 400, 400);
+
+#ifdef CHESS_OPENGL
+    // Platforms without a GL surface, such as offscreen CI runs, keep the raster engine.
+    // Elsewhere a machine without a GPU renders through Mesa's llvmpipe.
+    const QString platform = QGuiApplication::platformName();
+    if (platform != "offscreen" && platform != "minimal") {
+        QOpenGLWidget *glViewport = new QOpenGLWidget;
+        QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+        format.setSwapInterval(1); // Present in step with the display's refresh
+        format.setSamples(4);
+        glViewport->setFormat(format);
+        setViewport(glViewport);
+        // The GL framebuffer is not kept between frames, so each one is repainted whole
+        setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+        return;
+    }
+#endif
+    // Moves and highlights touch a few squares; repaint just those
+    setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+}
+
+void ChessBoard::setFrameTimeHud(bool show) {
+    if (show == (hudTimer != nullptr)) return;
+
+    if (show) {
+        // The HUD reports on frames painted for other reasons; refresh its own corner twice
+        // a second so the numbers don't go stale while nothing else changes
+        hudTimer = new QTimer(this);
+        connect(hudTimer, &QTimer::timeout, this, [this] { viewport()->update(HudRect); });
+        hudTimer->start(500);
+    } else {
+        delete hudTimer;
+        hudTimer = nullptr;
+    }
+    viewport()->update(HudRect);
+}
+
+void ChessBoard::keyPressEvent(QKeyEvent *event) {
+    if (event->key() == Qt::Key_F3) {
+        setFrameTimeHud(hudTimer == nullptr);
+        return;
+    }
+    QGraphicsView::keyPressEvent(event);
+}
+
+void ChessBoard::paintEvent(QPaintEvent *event) {
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+    frameTimes[frameCount++ % frameTimes.size()] = int(timer.nsecsElapsed() / 1000);
+}
+
+void ChessBoard::drawForeground(QPainter *painter, const QRectF &rect) {
+    QGraphicsView::drawForeground(painter, rect);
+    if (!hudTimer || frameCount == 0) return;
+
+    int frames = std::min<int>(frameCount, frameTimes.size());
+    int total = 0, worst = 0;
+    for (int i = 0; i < frames; ++i) {
+        total += frameTimes[i];
+        worst = std::max(worst, frameTimes[i]);
+    }
+
+    // Drawn in viewport coordinates, over everything in the scene
+    painter->save();
+    painter->resetTransform();
+    auto percentiles = [](const char *label, const LatencyHistogram &histogram) {
+        return QString("%1 p50 %2 p99 %3 p99.9 %4 us").arg(label)
+            .arg(histogram.percentile(0.5) / 1000).arg(histogram.percentile(0.99) / 1000).arg(histogram.percentile(0.999) / 1000);
+    };
+    QStringList lines;
+    lines << QString("frame %1 ms avg, %2 ms max").arg(total / 1000.0 / frames, 0, 'f', 2).arg(worst / 1000.0, 0, 'f', 2);
+    lines << percentiles("click", clickHistogram) << percentiles("move", moveHistogram);
+
+    painter->fillRect(HudRect, QColor(0, 0, 0, 160));
+    painter->setPen(Qt::white);
+    painter->setFont(QFont("Arial", 8));
+    painter->drawText(QRectF(HudRect).adjusted(4, 2, -4, -2), Qt::AlignLeft | Qt::AlignTop, lines.join('\n'));
+    painter->restore();
+}
+
+void ChessBoard::drawBoard() {
+    boardItem = new BoardItem;
+    scene->addItem(boardItem);
+}
+
+bool ChessBoard::playMove(Move move) {
+    // Drop a half-made selection so its highlights don't outlive the position
+    if (selectedPiece) {
+        selectedPiece->highlight(false);
+        selectedPiece = nullptr;
+        clearHighlights();
+    }
+
+    PieceType promotion = move.type() == MoveType::Promotion ? move.promotion() : PieceType::Queen;
+    return movePiece(pieceAt(rowOf(move.from()), colOf(move.from())), rowOf(move.to()), colOf(move.to()), promotion);
+}
+
+bool ChessBoard::undoMove() {
+    if (!canUndo()) return false;
+
+    if (selectedPiece) {
+        selectedPiece->highlight(false);
+        selectedPiece = nullptr;
+        clearHighlights();
+    }
+
+    Trace::Scope scope("undo move");
+    position.undoMove(history[--historyPly]);
+    syncScene();
+    generateLegalMoves(position, legalMoves);
+    emit positionChanged(position);
+    return true;
+}
+
+bool ChessBoard::redoMove() {
+    if (!canRedo()) return false;
+    return playMove(history[historyPly]);
+}
+
+std::vector<Move> ChessBoard::playedMoves() const {
+    return std::vector<Move>(history.begin(), history.begin() + historyPly);
+}
+
+void ChessBoard::jumpTo(const Position &target) {
+    if (selectedPiece) {
+        selectedPiece->highlight(false);
+        selectedPiece = nullptr;
+        clearHighlights();
+    }
+
+    history.clear();
+    historyPly = 0;
+
+    position = target;
+    startPos = target;
+    syncScene();
+    generateLegalMoves(position, legalMoves);
+    emit positionChanged(position);
+}
+
+void ChessBoard::syncScene() {
+    // Squares whose piece differs, from the bitboards of each piece before and after
+    Bitboard changed = 0;
+    for (int p = 0; p < 2 * PieceTypeCount; ++p) {
+        Bitboard now = position.pieces(colorOf(Piece(p)), typeOf(Piece(p)));
+        changed |= shownPieces[p] ^ now;
+        shownPieces[p] = now;
+    }
+    if (!changed) return;
+    Trace::Scope scope("scene sync", "squares", popcount(changed));
+    QElapsedTimer syncTimer;
+    syncTimer.start();
+
+    // A slide still running from the last sync ends now, and a drag in progress is
+    // dropped, so every item is on its square
+    animator->finish();
+    cancelDrag();
+
+    // Lift every item off a changed square first, so none is looked up after moving
+    std::vector<ChessPiece*> lifted[2 * PieceTypeCount];
+    for (Bitboard squares = changed; squares;) {
+        Square s = popLsb(squares);
+        if (ChessPiece *piece = squarePieces[s]) {
+            lifted[makePiece(piece->isWhitePiece() ? White : Black, piece->pieceType())].push_back(piece);
+            squarePieces[s] = nullptr;
+        }
+    }
+
+    // Refill: an item of the same piece if one was lifted, else any of that colour retyped,
+    // else a parked one, and only as a last resort a new item
+    auto takeFrom = [](std::vector<ChessPiece*> &pool) {
+        ChessPiece *piece = pool.back();
+        pool.pop_back();
+        return piece;
+    };
+    auto takeLifted = [&](Color c) -> ChessPiece * {
+        for (int pt = 0; pt < PieceTypeCount; ++pt) {
+            std::vector<ChessPiece*> &pool = lifted[makePiece(c, PieceType(pt))];
+            if (!pool.empty()) return takeFrom(pool);
+        }
+        return nullptr;
+    };
+    auto takeParked = [this](Color c, PieceType pt) -> ChessPiece * {
+        auto sameColor = [c](ChessPiece *piece) { return piece->isWhitePiece() == (c == White); };
+        auto it = std::find_if(parkedPieces.begin(), parkedPieces.end(), [&](ChessPiece *piece) {
+            return sameColor(piece) && piece->pieceType() == pt;
+        });
+        if (it == parkedPieces.end()) it = std::find_if(parkedPieces.begin(), parkedPieces.end(), sameColor);
+        if (it == parkedPieces.end()) return nullptr;
+        ChessPiece *piece = *it;
+        parkedPieces.erase(it);
+        return piece;
+    };
+
+    for (Bitboard squares = changed & position.pieces(); squares;) {
+        Square s = popLsb(squares);
+        Piece p = position.pieceOn(s);
+        Color c = colorOf(p);
+        PieceType pt = typeOf(p);
+
+        ChessPiece *piece = nullptr;
+        QPointF target(colOf(s) * 50, rowOf(s) * 50);
+        if (!lifted[p].empty() || (piece = takeLifted(c))) {
+            // Already on the board: slide it over, retyped if it promoted or unpromoted
+            if (!piece) piece = takeFrom(lifted[p]);
+            if (piece->pieceType() != pt) piece->setPieceType(pt);
+            animator->slide(piece, target);
+        } else {
+            if ((piece = takeParked(c, pt))) {
+                if (piece->pieceType() != pt) piece->setPieceType(pt);
+                piece->show();
+            } else {
+                piece = new ChessPiece(0, 0, pt, c == White);
+                scene->addItem(piece);
+            }
+            piece->setPos(target);
+        }
+        squarePieces[s] = piece;
+    }
+
+    // Whatever was lifted and not placed again has left the board
+    for (std::vector<ChessPiece*> &pool : lifted) {
+        for (ChessPiece *piece : pool) {
+            piece->hide();
+            parkedPieces.push_back(piece);
+        }
+    }
+
+    animator->start();
+    sceneSyncNanoseconds += syncTimer.nsecsElapsed();
+}
+
+void ChessBoard::setSideInteractive(Color side, bool interactive) {
+    interactiveSides[side] = interactive;
+    if (!interactive && selectedPiece && selectedPiece->isWhitePiece() == (side == White)) {
+        selectedPiece->highlight(false);
+        selectedPiece = nullptr;
+        clearHighlights();
+    }
+}
+
+bool ChessBoard::movePiece(ChessPiece *piece, int row, int col, PieceType promotion) {
+    if (!piece) return false;
+    animator->finish();
+
+    if (const Move *legalMove = findLegalMove(piece, row, col, promotion)) {
+        Trace::Scope scope("apply move", "move", legalMove->raw());
+        QElapsedTimer latency;
+        latency.start();
+        Move move = *legalMove;
+
+        // Replaying the next undone move keeps the rest of the redo line
+        if (historyPly == int(history.size()) || history[historyPly] != move) {
+            history.resize(historyPly);
+            history.push_back(move);
+        }
+        ++historyPly;
+
+        // Captures, castling rooks and promotions all fall out of the sync
+        position.doMove(move);
+        syncScene();
+        generateLegalMoves(position, legalMoves);
+        moveHistogram.record(latency.nsecsElapsed());
+        emit positionChanged(position);
+
+        // The move was successful
+        return true;
+    }
+
+    // The move was not successful (invalid move)
+    return false;
+}
+
+bool ChessBoard::moveByHand(ChessPiece *piece, int row, int col) {
+    if (!piece) return false;
+    Square from = squareOf(piece);
+    Square to = makeSquare(row, col);
+    bool promotes = std::any_of(legalMoves.begin(), legalMoves.end(), [&](const Move &move) {
+        return move.from() == from && move.to() == to && move.type() == MoveType::Promotion;
+    });
+    if (!promotes || !promotionPicker) return movePiece(piece, row, col);
+
+    std::optional<PieceType> promotion = pickPromotion(row, col, piece->isWhitePiece());
+    return promotion && movePiece(piece, row, col, *promotion);
+}
+
+std::optional<PieceType> ChessBoard::pickPromotion(int row, int col, bool isWhite) {
+    static constexpr std::pair<PieceType, const char*> Choices[] = {
+        {PieceType::Queen, "Queen"}, {PieceType::Rook, "Rook"}, {PieceType::Bishop, "Bishop"}, {PieceType::Knight, "Knight"},
+    };
+
+    QMenu menu(this);
+    for (const auto &[type, name] : Choices) {
+        QAction *action = menu.addAction(QIcon(PieceAtlas::glyph(type, isWhite)), name);
+        action->setData(int(type));
+    }
+    // Open it over the target square
+    QPoint corner = mapFromScene(QPointF(col * BoardItem::SquareSize, row * BoardItem::SquareSize));
+    QAction *chosen = menu.exec(viewport()->mapToGlobal(corner));
+    if (!chosen) return std::nullopt;
+    return PieceType(chosen->data().toInt());
+}
+
+ChessPiece *ChessBoard::pieceAt(int row, int col) const {
+    return squarePieces[makeSquare(row, col)];
+}
+
+bool ChessBoard::isValidMove(ChessPiece *piece, int newRow, int newCol) {
+    return findLegalMove(piece, newRow, newCol) != nullptr;
+}
+
+const Move *ChessBoard::findLegalMove(ChessPiece *piece, int newRow, int newCol, PieceType promotion) const {
+    if (!piece) return nullptr;
+
+    // Look the square up rather than reading the item's position, which a drag or slide moves
+    Square from = squareOf(piece);
+    Square to = makeSquare(newRow, newCol);
+
+    for (const Move &move : legalMoves) {
+        // Promotions only match the piece asked for
+        if (move.from() == from && move.to() == to && (move.type() != MoveType::Promotion || move.promotion() == promotion)) {
+            return &move;
+        }
+    }
+    return nullptr;
+}
+
+
+void ChessBoard::clearHighlights() {
+    boardItem->setHighlights(0);
+}
@@ -0,0 +1,176 @@
+#ifndef CHESS_CHESSBOARD_H
+#define CHESS_CHESSBOARD_H
+
+#include <QGraphicsView>
+#include <QGraphicsScene>
+#include <QBrush>
+#include <QTimer>
+
+#include "BoardItem.h"
+#include "ChessPiece.h"
+#include "LatencyHistogram.h"
+#include "PieceAnimator.h"
+#include "MoveGen.h"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
+// A move to mark on the board, such as one of the analysis lines, with a short caption
+struct MoveMark {
+    Move move;
+    QString caption;
+};
+
+class ChessBoard : public QGraphicsView {
+    Q_OBJECT
+
+public:
+    ChessBoard(QWidget *parent = nullptr) : QGraphicsView(parent), selectedPiece(nullptr) {
+        generateLegalMoves(position, legalMoves);
+
+        scene = new QGraphicsScene(this);
+        setScene(scene);
+        setFixedSize(400, 400);
+        setBackgroundBrush(QBrush(Qt::gray));
+        setupViewport();
+        animator = new PieceAnimator(this);
+
+        drawBoard();
+        PieceAtlas::setDevicePixelRatio(devicePixelRatioF());
+        // The scene starts empty, so the first sync creates an item for every piece
+        syncScene();
+    }
+
+    const Position &currentPosition() const { return position; }
+    const MoveList &currentLegalMoves() const { return legalMoves; }
+
+    // Plays a move chosen elsewhere (e.g. by the engine) through the same path as a click
+    bool playMove(Move move);
+
+    // Steps back and forth through the moves played. Redo replays moves undone since the
+    // last new move; playing anything else drops them.
+    bool undoMove();
+    bool redoMove();
+    // The position's undo ring only reaches MaxStates - 1 plies back from the latest move
+    bool canUndo() const { return historyPly > std::max(0, int(history.size()) - (MaxStates - 1)); }
+    bool canRedo() const { return historyPly < int(history.size()); }
+
+    // Shows another position, touching only the squares that differ. The move history
+    // starts afresh from there.
+    void jumpTo(const Position &target);
+
+    // Where the history starts and the moves played from there up to the current ply
+    const Position &startPosition() const { return startPos; }
+    std::vector<Move> playedMoves() const;
+
+    // Sides that are not interactive ignore clicks, e.g. while the engine plays them
+    void setSideInteractive(Color side, bool interactive);
+
+    // Whether a pawn played by hand to the last rank asks which piece it becomes; without
+    // the picker it always becomes a queen, e.g. for headless replays
+    void setPromotionPicker(bool enabled) { promotionPicker = enabled; }
+
+    // Shows how long recent frames took to paint and the latency percentiles below in the
+    // top-left corner; F3 toggles it
+    void setFrameTimeHud(bool show);
+
+    // From a press that selects a piece to its targets being highlighted, and from a move
+    // being accepted to the scene showing it
+    const LatencyHistogram &clickLatency() const { return clickHistogram; }
+    const LatencyHistogram &moveLatency() const { return moveHistogram; }
+    // Total time spent bringing the scene in line with the position, in nanoseconds
+    std::int64_t sceneSyncTime() const { return sceneSyncNanoseconds; }
+
+public slots:
+    // Colours the target squares of the given moves, best first; an empty list clears them
+    void setMoveMarks(const QList<MoveMark> &marks);
+
+signals:
+    // Emitted after every move played on the board
+    void positionChanged(const Position &position);
+    // Every press on the board that is handled, in scene coordinates, e.g. to record a session
+    void pressed(const QPointF &scenePos);
+
+protected:
+    // A press on a piece selects it and may start dragging it; releasing over a legal
+    // target plays the move, anywhere else puts the piece back
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    // Re-renders the glyph atlas when the board first shows on a high-density screen
+    void showEvent(QShowEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
+
+private:
+    // Picks the viewport (OpenGL when built with CHESS_OPENGL) and its update strategy
+    void setupViewport();
+    void drawBoard();
+    // Brings the items in line with position by moving, retyping, hiding or showing only
+    // those on squares whose piece changed since the last sync. Pieces that stay on the
+    // board slide to their new squares.
+    void syncScene();
+    Square squareOf(const ChessPiece *piece) const;
+    Bitboard targetsFrom(Square from) const;
+    void cancelDrag();
+    bool isValidMove(ChessPiece *piece, int row, int col);
+    const Move *findLegalMove(ChessPiece *piece, int row, int col, PieceType promotion = PieceType::Queen) const;
+    void highlightValidMoves(ChessPiece *piece, bool highlight = true);
+    // Plays a click or drop, asking for the promotion piece first when the move promotes
+    bool moveByHand(ChessPiece *piece, int row, int col);
+    // Pops up the four promotion pieces by the target square; nothing if dismissed
+    std::optional<PieceType> pickPromotion(int row, int col, bool isWhite);
+
+    QGraphicsScene *scene;
+    ChessPiece *selectedPiece;
+    QPointF originalPos;
+
+    // The piece being dragged and the squares it may drop on, fixed when the press
+    // selected it so pointer moves only test a bit
+    ChessPiece *draggedPiece = nullptr;
+    Bitboard dragTargets = 0;
+    QPointF dragOffset;
+    QPoint pressPos;
+    bool dragMoved = false;
+    BoardItem *boardItem;
+    PieceAnimator *animator;
+
+    // The position is the source of truth and the scene follows it; legalMoves is
+    // regenerated once per position
+    Position position;
+    MoveList legalMoves;
+    bool interactiveSides[2] = {true, true};
+    bool promotionPicker = true;
+
+    // What the scene currently shows: the item on each square and the piece bitboards
+    // the items were last synced to, indexed by Piece
+    ChessPiece *squarePieces[64] = {};
+    std::array<Bitboard, 2 * PieceTypeCount> shownPieces = {};
+
+    std::vector<Move> history;
+    int historyPly = 0;
+    Position startPos;
+
+    // Items taken off the board, e.g. by captures, kept hidden for reuse by later syncs
+    std::vector<ChessPiece*> parkedPieces;
+
+    bool movePiece(ChessPiece *piece, int row, int col, PieceType promotion = PieceType::Queen);
+    ChessPiece *pieceAt(int row, int col) const;
+
+    void clearHighlights();
+
+    // Paint times of the last frames in microseconds, recorded always, shown by the HUD
+    std::array<int, 60> frameTimes = {};
+    int frameCount = 0;
+    QTimer *hudTimer = nullptr;
+
+    LatencyHistogram clickHistogram;
+    LatencyHistogram moveHistogram;
+    std::int64_t sceneSyncNanoseconds = 0;
+};
+
+
+#endif //CHESS_CHESSBOARD_H
@@ -0,0 +1,5 @@
+#include "ChessPiece.h"
+
+// Definition of the static type identifier for ChessPiece
+// This needs to be done in a source file (.cpp), not in the header (.h)
+const int ChessPiece::Type = QGraphicsItem::UserType + 1;
@@ -0,0 +1,47 @@
+#ifndef CHESS_CHESSPIECE_H
+#define CHESS_CHESSPIECE_H
+
+#include <QGraphicsPixmapItem>
+
+#include "PieceAtlas.h"
+#include "Types.h"
+
+class ChessPiece : public QGraphicsPixmapItem {
+public:
+    static const int Type; // Declaration of the static type identifier for ChessPiece
+
+    ChessPiece(int x, int y, PieceType type, bool isWhite)
+            : QGraphicsPixmapItem(PieceAtlas::glyph(type, isWhite)), m_pieceType(type), m_isWhite(isWhite) {
+        setPos(x, y);
+        // Hit-test the square rather than the glyph's alpha mask
+        setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
+    }
+
+    // Returns the chess piece type (e.g., Pawn, Rook, etc.)
+    PieceType pieceType() const { return m_pieceType; }
+
+    // Turns the piece into another type in place, e.g. for promotion and its undo
+    void setPieceType(PieceType type) {
+        m_pieceType = type;
+        refreshGlyph();
+    }
+    // Picks up the glyph again after the atlas was rendered at another pixel ratio
+    void refreshGlyph() { setPixmap(PieceAtlas::glyph(m_pieceType, m_isWhite)); }
+    bool isWhitePiece() const { return m_isWhite; }
+
+    void highlight(bool highlight = true) {
+        setOpacity(highlight ? 0.5 : 1.0);
+    }
+
+    // Override the QGraphicsItem::type() method to return our custom type identifier
+    int type() const override {
+        return Type;
+    }
+
+private:
+    PieceType m_pieceType; // Using m_ prefix for member variables for clarity
+    bool m_isWhite;
+};
+
+
+#endif //CHESS_CHESSPIECE_H
@@ -0,0 +1,127 @@
+#include "ClickReplay.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QTest>
+
+#include "ChessBoard.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool loadClicks(const std::string &path, std::vector<QPointF> &clicks, std::string &error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    clicks.clear();
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::string first;
+        if (!(tokens >> first)) continue;
+
+        // A square name clicks the middle of the square
+        if (first.size() == 2 && first[0] >= 'a' && first[0] <= 'h' && first[1] >= '1' && first[1] <= '8') {
+            clicks.emplace_back((first[0] - 'a') * 50 + 25, (first[1] - '1') * 50 + 25);
+            continue;
+        }
+
+        std::istringstream coordinates(line);
+        double x, y;
+        if (!(coordinates >> x >> y)) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected \"x y\" or a square";
+            return false;
+        }
+        clicks.emplace_back(x, y);
+    }
+    return true;
+}
+
+int runLatencyHarness(int argc, char *argv[], const std::string &path, int repeats, double p99BudgetUs) {
+    std::vector<QPointF> clicks;
+    std::string error;
+    if (!loadClicks(path, clicks, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    // CI machines have no display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ChessBoard board;
+    board.setPromotionPicker(false);
+    board.show();
+
+    for (int run = 0; run < std::max(repeats, 1); ++run) {
+        board.jumpTo(Position());
+        for (const QPointF &click : clicks) {
+            QTest::mouseClick(board.viewport(), Qt::LeftButton, Qt::NoModifier, board.mapFromScene(click));
+            // Let the scene repaint as it would between real clicks
+            QCoreApplication::processEvents();
+        }
+    }
+
+    const LatencyHistogram &click = board.clickLatency();
+    const LatencyHistogram &move = board.moveLatency();
+    std::cout << click.summary("click to highlight") << '\n' << move.summary("move to scene") << std::endl;
+
+    if (p99BudgetUs > 0) {
+        for (const LatencyHistogram *histogram : {&click, &move}) {
+            if (histogram->percentile(0.99) / 1000.0 > p99BudgetUs) {
+                std::cerr << "p99 latency over the budget of " << p99BudgetUs << " us" << std::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int runClickBench(int argc, char *argv[], const std::string &path, int repeats) {
+    std::vector<QPointF> clicks;
+    std::string error;
+    if (!loadClicks(path, clicks, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ChessBoard board;
+    board.setPromotionPicker(false);
+    board.show();
+    QCoreApplication::processEvents();
+
+    repeats = std::max(repeats, 1);
+    std::int64_t events = 0;
+    QElapsedTimer wall;
+    wall.start();
+    for (int run = 0; run < repeats; ++run) {
+        board.jumpTo(Position());
+        for (const QPointF &click : clicks) {
+            QPoint pos = board.mapFromScene(click);
+            QPoint global = board.viewport()->mapToGlobal(pos);
+            QMouseEvent press(QEvent::MouseButtonPress, pos, global, Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+            QMouseEvent release(QEvent::MouseButtonRelease, pos, global, Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+            QCoreApplication::sendEvent(board.viewport(), &press);
+            QCoreApplication::sendEvent(board.viewport(), &release);
+            events += 2;
+        }
+    }
+    // The scene changes queued up so far are painted once here
+    QCoreApplication::processEvents();
+    double seconds = wall.nsecsElapsed() / 1e9;
+
+    std::cout << "guibench " << clicks.size() << " clicks x " << repeats << ": " << events << " events in "
+              << seconds * 1000 << " ms, " << static_cast<std::int64_t>(events / std::max(seconds, 1e-9)) << " events/s\n"
+              << "scene updates " << board.sceneSyncTime() / 1e6 << " ms total\n"
+              << board.clickLatency().summary("click to highlight") << '\n'
+              << board.moveLatency().summary("move to scene") << std::endl;
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef CHESS_CLICKREPLAY_H
+#define CHESS_CLICKREPLAY_H
+
+#include <QPointF>
+
+#include <string>
+#include <vector>
+
+// Recorded click sessions: one press per line, either as scene coordinates "x y" or as a
+// square name such as "e2". '#' starts a comment. Set CHESS_RECORD_CLICKS=<file> when
+// running the GUI to record one.
+bool loadClicks(const std::string &path, std::vector<QPointF> &clicks, std::string &error);
+
+// Replays a session through QTest on the offscreen platform, the given number of times
+// from the initial position, and prints the click and move latency percentiles. Fails
+// if a p99 exceeds the budget in microseconds (0 for no budget), to catch regressions.
+int runLatencyHarness(int argc, char *argv[], const std::string &path, int repeats, double p99BudgetUs);
+
+// Sends a session's presses and releases straight to the board as synthetic mouse events,
+// without waiting for repaints in between, and reports events per second and the time
+// spent updating the scene. Runs on the offscreen platform, so it needs no display.
+int runClickBench(int argc, char *argv[], const std::string &path, int repeats);
+
+#endif //CHESS_CLICKREPLAY_H
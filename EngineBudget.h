@@ -0,0 +1,23 @@
+#ifndef CHESS_ENGINEBUDGET_H
+#define CHESS_ENGINEBUDGET_H
+
+#include <algorithm>
+#include <thread>
+
+// The GUI runs two engines, the opponent and the analysis, which may both search at once.
+// One core stays with the GUI thread so the board keeps repainting; the remaining cores
+// and the hash memory are split evenly between the two.
+namespace EngineBudget {
+    constexpr int Engines = 2;
+    constexpr int HashMegabytes = 64; // For all engines together
+
+    inline int threadsPerEngine() {
+        return std::max(1, (int(std::thread::hardware_concurrency()) - 1) / Engines);
+    }
+
+    inline int hashPerEngine() {
+        return HashMegabytes / Engines;
+    }
+}
+
+#endif //CHESS_ENGINEBUDGET_H
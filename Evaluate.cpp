@@ -0,0 +1,112 @@
+#include "Evaluate.h"
+#include "Stats.h"
+
+#include <algorithm>
+
+namespace {
+    // Piece-square tables written from White's side with rank 8 on the first line, so a
+    // white piece on (row, col) reads entry (7 - row) * 8 + col and a black one row * 8 + col.
+    const int PawnTable[64] = {
+         0,   0,   0,   0,   0,   0,   0,   0,
+        50,  50,  50,  50,  50,  50,  50,  50,
+        10,  10,  20,  30,  30,  20,  10,  10,
+         5,   5,  10,  25,  25,  10,   5,   5,
+         0,   0,   0,  20,  20,   0,   0,   0,
+         5,  -5, -10,   0,   0, -10,  -5,   5,
+         5,  10,  10, -20, -20,  10,  10,   5,
+         0,   0,   0,   0,   0,   0,   0,   0
+    };
+    const int KnightTable[64] = {
+        -50, -40, -30, -30, -30, -30, -40, -50,
+        -40, -20,   0,   0,   0,   0, -20, -40,
+        -30,   0,  10,  15,  15,  10,   0, -30,
+        -30,   5,  15,  20,  20,  15,   5, -30,
+        -30,   0,  15,  20,  20,  15,   0, -30,
+        -30,   5,  10,  15,  15,  10,   5, -30,
+        -40, -20,   0,   5,   5,   0, -20, -40,
+        -50, -40, -30, -30, -30, -30, -40, -50
+    };
+    const int BishopTable[64] = {
+        -20, -10, -10, -10, -10, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,  10,  10,   5,   0, -10,
+        -10,   5,   5,  10,  10,   5,   5, -10,
+        -10,   0,  10,  10,  10,  10,   0, -10,
+        -10,  10,  10,  10,  10,  10,  10, -10,
+        -10,   5,   0,   0,   0,   0,   5, -10,
+        -20, -10, -10, -10, -10, -10, -10, -20
+    };
+    const int RookTable[64] = {
+         0,   0,   0,   0,   0,   0,   0,   0,
+         5,  10,  10,  10,  10,  10,  10,   5,
+        -5,   0,   0,   0,   0,   0,   0,  -5,
+        -5,   0,   0,   0,   0,   0,   0,  -5,
+        -5,   0,   0,   0,   0,   0,   0,  -5,
+        -5,   0,   0,   0,   0,   0,   0,  -5,
+        -5,   0,   0,   0,   0,   0,   0,  -5,
+         0,   0,   0,   5,   5,   0,   0,   0
+    };
+    const int QueenTable[64] = {
+        -20, -10, -10,  -5,  -5, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,   5,   5,   5,   0, -10,
+         -5,   0,   5,   5,   5,   5,   0,  -5,
+          0,   0,   5,   5,   5,   5,   0,  -5,
+        -10,   5,   5,   5,   5,   5,   0, -10,
+        -10,   0,   5,   0,   0,   0,   0, -10,
+        -20, -10, -10,  -5,  -5, -10, -10, -20
+    };
+    const int KingMiddleGameTable[64] = {
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -20, -30, -30, -40, -40, -30, -30, -20,
+        -10, -20, -20, -20, -20, -20, -20, -10,
+         20,  20,   0,   0,   0,   0,  20,  20,
+         20,  30,  10,   0,   0,  10,  30,  20
+    };
+    const int KingEndGameTable[64] = {
+        -50, -40, -30, -20, -20, -30, -40, -50,
+        -30, -20, -10,   0,   0, -10, -20, -30,
+        -30, -10,  20,  30,  30,  20, -10, -30,
+        -30, -10,  30,  40,  40,  30, -10, -30,
+        -30, -10,  30,  40,  40,  30, -10, -30,
+        -30, -10,  20,  30,  30,  20, -10, -30,
+        -30, -30,   0,   0,   0,   0, -30, -30,
+        -50, -30, -30, -30, -30, -30, -30, -50
+    };
+
+    // Indexed by PieceType; the king is tapered separately
+    const int *const PieceTables[PieceTypeCount] = {PawnTable, RookTable, KnightTable, BishopTable, QueenTable, nullptr};
+
+    // Non-pawn material of both sides at the start, used to blend king tables
+    constexpr int FullPhase = 2 * (2 * 500 + 2 * 320 + 2 * 330 + 900);
+
+    int tableIndex(Color c, Square s) {
+        return c == White ? (7 - rowOf(s)) * 8 + colOf(s) : s;
+    }
+}
+
+int evaluate(const Position &pos) {
+    CHESS_STAT(EvalCalls);
+    int score[2] = {0, 0};
+    int phase = 0;
+
+    for (Color c : {White, Black}) {
+        for (int pt = 0; pt < int(PieceType::King); ++pt) {
+            Bitboard b = pos.pieces(c, PieceType(pt));
+            if (pt != int(PieceType::Pawn)) phase += popcount(b) * PieceValues[pt];
+            while (b) score[c] += PieceValues[pt] + PieceTables[pt][tableIndex(c, popLsb(b))];
+        }
+    }
+
+    phase = std::min(phase, FullPhase);
+    for (Color c : {White, Black}) {
+        int index = tableIndex(c, pos.kingSquare(c));
+        score[c] += (KingMiddleGameTable[index] * phase + KingEndGameTable[index] * (FullPhase - phase)) / FullPhase;
+    }
+
+    int whiteScore = score[White] - score[Black];
+    return pos.sideToMove() == White ? whiteScore : -whiteScore;
+}
@@ -0,0 +1,12 @@
+#ifndef CHESS_EVALUATE_H
+#define CHESS_EVALUATE_H
+
+#include "Position.h"
+
+// Material values in centipawns, indexed by PieceType
+constexpr int PieceValues[PieceTypeCount] = {100, 500, 320, 330, 900, 0};
+
+// Static evaluation from the point of view of the side to move
+int evaluate(const Position &pos);
+
+#endif //CHESS_EVALUATE_H
@@ -0,0 +1,265 @@
+#include "GamePanel.h"
+
+#include "ChessBoard.h"
+#include "EngineBudget.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QKeySequence>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace {
+    const char *const SideNames[2] = {"White", "Black"};
+}
+
+GamePanel::GamePanel(ChessBoard *board, QWidget *parent)
+        : QWidget(parent), m_board(board), m_engine(EngineBudget::threadsPerEngine(), EngineBudget::hashPerEngine()) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    for (Color side : {White, Black}) {
+        SideControls &controls = m_sides[side];
+        controls.player = new QComboBox(this);
+        controls.player->addItems({"Human", "Engine"});
+        controls.moveTime = new QSpinBox(this);
+        controls.moveTime->setRange(0, 600000);
+        controls.moveTime->setSingleStep(500);
+        controls.moveTime->setSuffix(" ms");
+        controls.moveTime->setSpecialValueText("No limit");
+        controls.moveTime->setValue(2000);
+        controls.depth = new QSpinBox(this);
+        controls.depth->setRange(0, MaxPly - 1);
+        controls.depth->setSpecialValueText("No limit");
+
+        QFormLayout *form = new QFormLayout;
+        form->addRow(SideNames[side], controls.player);
+        form->addRow("Time per move", controls.moveTime);
+        form->addRow("Depth", controls.depth);
+        layout->addLayout(form);
+
+        connect(controls.player, &QComboBox::currentIndexChanged, this, &GamePanel::updateSides);
+    }
+
+    m_ponderToggle = new QCheckBox("Ponder on the opponent's time", this);
+    layout->addWidget(m_ponderToggle);
+    connect(m_ponderToggle, &QCheckBox::toggled, this, [this](bool on) { if (!on) stopPondering(); });
+
+    m_undoButton = new QPushButton("Undo", this);
+    m_undoButton->setShortcut(QKeySequence::Undo);
+    m_redoButton = new QPushButton("Redo", this);
+    m_redoButton->setShortcut(QKeySequence::Redo);
+    m_resignButton = new QPushButton("Resign", this);
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setWordWrap(true);
+
+    QHBoxLayout *historyLayout = new QHBoxLayout;
+    historyLayout->addWidget(m_undoButton);
+    historyLayout->addWidget(m_redoButton);
+    layout->addLayout(historyLayout);
+    layout->addWidget(m_resignButton);
+    layout->addWidget(m_statusLabel);
+    setFixedWidth(220);
+
+    connect(m_undoButton, &QPushButton::clicked, this, &GamePanel::undo);
+    connect(m_redoButton, &QPushButton::clicked, this, &GamePanel::redo);
+    connect(m_resignButton, &QPushButton::clicked, this, &GamePanel::resign);
+
+    // Called on the engine's main search thread; hop over to the GUI thread
+    m_engine.setBestMoveCallback([this](const SearchResult &result) {
+        QMetaObject::invokeMethod(this, [this, result] { playEngineMove(result); }, Qt::QueuedConnection);
+    });
+
+    updateStatus();
+}
+
+GamePanel::~GamePanel() {
+    m_engine.stop();
+}
+
+void GamePanel::setPosition(const Position &position) {
+    m_searchId = 0;
+    if (m_gameOver || m_navigating) return;
+
+    // The board already generated the legal moves of this position, so reuse them
+    GameResult result = gameResult(position, m_board->currentLegalMoves());
+    if (result != GameResult::Ongoing) {
+        endGame(resultText(result, position.sideToMove()));
+        return;
+    }
+
+    // The human played the predicted move: the ponder search simply becomes the real one
+    if (m_ponderId && position.key() == m_ponderKey && isEngine(position.sideToMove())) {
+        m_searchId = m_ponderId;
+        m_ponderId = 0;
+        m_engine.ponderhit();
+        updateStatus();
+        return;
+    }
+    stopPondering();
+
+    if (isEngine(position.sideToMove())) think();
+    updateStatus();
+}
+
+void GamePanel::resign() {
+    if (m_gameOver) return;
+
+    // With the engine to move, the resigning human is the one waiting on it
+    Color side = m_board->currentPosition().sideToMove();
+    if (isEngine(side) && !isEngine(~side)) side = ~side;
+
+    endGame(QString("%1 resigns, %2 wins").arg(SideNames[side]).arg(SideNames[~side]));
+}
+
+void GamePanel::undo() {
+    // Whatever the engine was doing belongs to the position being left
+    m_engine.stop();
+    m_searchId = 0;
+    m_ponderId = 0;
+
+    m_navigating = true;
+    bool undone = m_board->undoMove();
+    Color toMove = m_board->currentPosition().sideToMove();
+    if (undone && isEngine(toMove) && !isEngine(~toMove)) m_board->undoMove();
+    m_navigating = false;
+
+    if (undone) resume();
+}
+
+void GamePanel::redo() {
+    m_engine.stop();
+    m_searchId = 0;
+    m_ponderId = 0;
+
+    m_navigating = true;
+    bool redone = m_board->redoMove();
+    Color toMove = m_board->currentPosition().sideToMove();
+    if (redone && isEngine(toMove) && !isEngine(~toMove)) m_board->redoMove();
+    m_navigating = false;
+
+    if (redone) resume();
+}
+
+void GamePanel::resume() {
+    m_engine.stop();
+    m_searchId = 0;
+    m_ponderId = 0;
+    m_gameOver = false;
+    m_resignButton->setEnabled(true);
+    for (Color side : {White, Black}) m_board->setSideInteractive(side, !isEngine(side));
+    setPosition(m_board->currentPosition());
+}
+
+void GamePanel::endGame(const QString &result) {
+    m_engine.stop();
+    m_searchId = 0;
+    m_ponderId = 0;
+    m_gameOver = true;
+    m_board->setSideInteractive(White, false);
+    m_board->setSideInteractive(Black, false);
+    m_resignButton->setEnabled(false);
+    updateStatus();
+    m_statusLabel->setText(result);
+}
+
+QString GamePanel::resultText(GameResult result, Color sideToMove) {
+    switch (result) {
+        case GameResult::Checkmate: return QString("Checkmate, %1 wins").arg(SideNames[~sideToMove]);
+        case GameResult::Stalemate: return "Draw by stalemate";
+        case GameResult::FiftyMoves: return "Draw by the fifty-move rule";
+        case GameResult::Repetition: return "Draw by threefold repetition";
+        case GameResult::InsufficientMaterial: return "Draw by insufficient material";
+        case GameResult::Ongoing: break;
+    }
+    return QString();
+}
+
+void GamePanel::updateSides() {
+    if (m_gameOver) return;
+    stopPondering();
+
+    for (Color side : {White, Black}) m_board->setSideInteractive(side, !isEngine(side));
+
+    // Start or abandon a search if the side to move just changed hands
+    Color toMove = m_board->currentPosition().sideToMove();
+    if (isEngine(toMove) && !m_searchId) {
+        think();
+    } else if (!isEngine(toMove) && m_searchId) {
+        m_engine.stop();
+        m_searchId = 0;
+    }
+    updateStatus();
+}
+
+void GamePanel::think() {
+    const Position &position = m_board->currentPosition();
+    m_searchId = m_engine.go(position, limitsFor(position.sideToMove()));
+}
+
+void GamePanel::ponder(const Position &position, Move expected) {
+    // Search the position after the expected reply with the limits of the side to play there
+    Position predicted = position;
+    predicted.doMove(expected);
+
+    SearchLimits limits = limitsFor(predicted.sideToMove());
+    limits.ponder = true;
+    m_ponderKey = predicted.key();
+    m_ponderId = m_engine.go(predicted, limits);
+}
+
+void GamePanel::stopPondering() {
+    if (!m_ponderId) return;
+    m_engine.stop();
+    m_ponderId = 0;
+}
+
+void GamePanel::playEngineMove(const SearchResult &result) {
+    // Results of searches that were stopped or superseded since
+    if (result.searchId != m_searchId || m_gameOver) return;
+    m_searchId = 0;
+
+    if (result.bestMove.isNone() || !m_board->playMove(result.bestMove)) return;
+
+    // Only ponder against a human; against itself the engine moves straight away
+    const Position &position = m_board->currentPosition();
+    if (!m_ponderToggle->isChecked() || result.ponderMove.isNone() || isEngine(position.sideToMove())) return;
+
+    // The predicted reply comes from the PV, so make sure it is legal in the real game
+    const MoveList &legalMoves = m_board->currentLegalMoves();
+    if (std::find(legalMoves.begin(), legalMoves.end(), result.ponderMove) != legalMoves.end()) {
+        ponder(position, result.ponderMove);
+        updateStatus();
+    }
+}
+
+void GamePanel::updateStatus() {
+    m_undoButton->setEnabled(m_board->canUndo());
+    m_redoButton->setEnabled(m_board->canRedo());
+    if (m_gameOver) return;
+    QString side = SideNames[m_board->currentPosition().sideToMove()];
+    if (m_searchId) {
+        m_statusLabel->setText(side + " (engine) is thinking...");
+    } else {
+        m_statusLabel->setText(side + (m_ponderId ? " to move, engine is pondering" : " to move"));
+    }
+}
+
+bool GamePanel::isEngine(Color side) const {
+    return m_sides[side].player->currentIndex() == 1;
+}
+
+SearchLimits GamePanel::limitsFor(Color side) const {
+    SearchLimits limits;
+    limits.moveTimeMs = m_sides[side].moveTime->value();
+    limits.depth = m_sides[side].depth->value();
+
+    // Never leave the engine thinking forever
+    if (!limits.moveTimeMs && !limits.depth) limits.moveTimeMs = 2000;
+    return limits;
+}
@@ -0,0 +1,72 @@
+#ifndef CHESS_GAMEPANEL_H
+#define CHESS_GAMEPANEL_H
+
+#include <QWidget>
+
+#include "Search.h"
+
+class ChessBoard;
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+
+// Chooses who plays each side. Engine sides search on background threads and their
+// moves come back through queued calls, so the board keeps repainting while they think.
+// With pondering on, the engine keeps searching the expected reply on the human's time.
+class GamePanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit GamePanel(ChessBoard *board, QWidget *parent = nullptr);
+    ~GamePanel() override;
+
+public slots:
+    // Starts the engine when it has the move
+    void setPosition(const Position &position);
+    void resign();
+    // Against the engine these step over its reply too, so the human stays on move
+    void undo();
+    void redo();
+    // Picks the game up again at the board's position, e.g. after jumping through a replay
+    void resume();
+
+private:
+    struct SideControls {
+        QComboBox *player;
+        QSpinBox *moveTime;
+        QSpinBox *depth;
+    };
+
+    void endGame(const QString &result);
+    static QString resultText(GameResult result, Color sideToMove);
+    void updateSides();
+    void think();
+    void ponder(const Position &position, Move expected);
+    void stopPondering();
+    void playEngineMove(const SearchResult &result);
+    void updateStatus();
+
+    bool isEngine(Color side) const;
+    SearchLimits limitsFor(Color side) const;
+
+    ChessBoard *m_board;
+    Engine m_engine;
+    std::uint64_t m_searchId = 0;
+    bool m_gameOver = false;
+    bool m_navigating = false; // Stepping through history; intermediate positions are skipped
+
+    // Running ponder search and the position it expects the human to reach
+    std::uint64_t m_ponderId = 0;
+    Key m_ponderKey = 0;
+
+    SideControls m_sides[2];
+    QCheckBox *m_ponderToggle;
+    QPushButton *m_undoButton;
+    QPushButton *m_redoButton;
+    QPushButton *m_resignButton;
+    QLabel *m_statusLabel;
+};
+
+#endif //CHESS_GAMEPANEL_H
@@ -0,0 +1,75 @@
+#include "GameRecord.h"
+#include "Uci.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+GameRecord::GameRecord() : m_keyframes{Position().snapshot()} {}
+
+GameRecord::GameRecord(const Position &start, const std::vector<Move> &moves) : m_moves(moves) {
+    Position pos = start;
+    m_keyframes.push_back(pos.snapshot());
+    for (int ply = 0; ply < length(); ++ply) {
+        pos.doMove(m_moves[ply]);
+        if ((ply + 1) % KeyframeInterval == 0) m_keyframes.push_back(pos.snapshot());
+    }
+}
+
+bool GameRecord::load(const std::string &text) {
+    std::istringstream in(text);
+    std::string token;
+    Position pos;
+
+    if (in >> token && token == "fen") {
+        // The FEN is the rest of the line, however many of its fields it has
+        std::string fen;
+        std::getline(in, fen);
+        if (!pos.setFen(fen)) return false;
+    } else {
+        // No header: the first token is already a move
+        in.clear();
+        in.seekg(0);
+    }
+
+    std::vector<Move> moves;
+    std::vector<PositionSnapshot> keyframes{pos.snapshot()};
+    while (in >> token) {
+        if (token.back() == '.' || token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") continue;
+
+        Move move = parseUciMove(pos, token);
+        if (move.isNone()) return false;
+        pos.doMove(move);
+        moves.push_back(move);
+        if (moves.size() % KeyframeInterval == 0) keyframes.push_back(pos.snapshot());
+    }
+
+    m_moves = std::move(moves);
+    m_keyframes = std::move(keyframes);
+    return true;
+}
+
+std::string GameRecord::save() const {
+    Position start;
+    start.restore(m_keyframes.front());
+    std::string text = "fen " + start.fen() + "\n";
+
+    // Number the moves the usual way, which load() skips over again
+    int fullMove = 1 + start.gamePly() / 2;
+    for (int ply = 0; ply < length(); ++ply) {
+        bool whiteMove = (start.gamePly() + ply) % 2 == 0;
+        if (whiteMove) text += std::to_string(fullMove) + ". ";
+        else if (ply == 0) text += std::to_string(fullMove) + "... ";
+        text += moveToUci(m_moves[ply]) + (whiteMove ? " " : "\n");
+        if (!whiteMove) ++fullMove;
+    }
+    if (!text.empty() && text.back() == ' ') text.back() = '\n';
+    return text;
+}
+
+void GameRecord::positionAt(int ply, Position &pos) const {
+    ply = std::clamp(ply, 0, length());
+    int keyframe = ply / KeyframeInterval;
+    pos.restore(m_keyframes[keyframe]);
+    for (int i = keyframe * KeyframeInterval; i < ply; ++i) pos.doMove(m_moves[i]);
+}
@@ -0,0 +1,35 @@
+#ifndef CHESS_GAMERECORD_H
+#define CHESS_GAMERECORD_H
+
+#include "Position.h"
+
+#include <string>
+#include <vector>
+
+// A stored game: a start position and its moves. A snapshot of the position is kept every
+// KeyframeInterval plies, so seeking to any ply replays fewer than that many moves.
+// Seeking can't see repetitions across a keyframe, which a replay doesn't need.
+class GameRecord {
+public:
+    static constexpr int KeyframeInterval = 16;
+
+    GameRecord();
+    GameRecord(const Position &start, const std::vector<Move> &moves);
+
+    // Text form: an optional "fen <FEN>" line, then UCI moves. Move numbers ("12.") and a
+    // trailing result are skipped. Fails on an illegal move and leaves the record unchanged.
+    bool load(const std::string &text);
+    std::string save() const;
+
+    int length() const { return int(m_moves.size()); }
+    Move move(int ply) const { return m_moves[ply]; }
+
+    // Position after the first ply moves
+    void positionAt(int ply, Position &pos) const;
+
+private:
+    std::vector<Move> m_moves;
+    std::vector<PositionSnapshot> m_keyframes; // Entry i is the position after i * KeyframeInterval moves
+};
+
+#endif //CHESS_GAMERECORD_H
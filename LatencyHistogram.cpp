@@ -0,0 +1,59 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+// Values below SubBuckets get a bucket each; above, each power of two [2^e, 2^(e+1))
+// is split into SubBuckets equal steps
+int LatencyHistogram::bucketOf(std::uint64_t value) {
+    if (value < SubBuckets) return int(value);
+    int exponent = std::bit_width(value) - 1;
+    int step = int(value >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+    return (exponent - SubBucketBits + 1) * SubBuckets + step;
+}
+
+std::int64_t LatencyHistogram::upperBound(int bucket) {
+    if (bucket < SubBuckets) return bucket;
+    int exponent = bucket / SubBuckets + SubBucketBits - 1;
+    std::uint64_t lower = std::uint64_t(SubBuckets + bucket % SubBuckets) << (exponent - SubBucketBits);
+    return std::int64_t(lower + (std::uint64_t(1) << (exponent - SubBucketBits)) - 1);
+}
+
+void LatencyHistogram::record(std::int64_t nanoseconds) {
+    nanoseconds = std::max<std::int64_t>(nanoseconds, 0);
+    ++m_buckets[bucketOf(std::uint64_t(nanoseconds))];
+    ++m_count;
+    m_max = std::max(m_max, nanoseconds);
+}
+
+void LatencyHistogram::reset() {
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max = 0;
+}
+
+std::int64_t LatencyHistogram::percentile(double fraction) const {
+    if (m_count == 0) return 0;
+    std::uint64_t target = std::max<std::uint64_t>(1, std::uint64_t(std::ceil(fraction * m_count)));
+    std::uint64_t seen = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        seen += m_buckets[bucket];
+        // The top bucket is known more exactly by the maximum
+        if (seen >= target) return std::min(upperBound(bucket), m_max);
+    }
+    return m_max;
+}
+
+std::string LatencyHistogram::summary(const std::string &label) const {
+    auto micros = [](std::int64_t nanoseconds) { return nanoseconds / 1000.0; };
+    std::ostringstream out;
+    out << label << ": n " << m_count << std::fixed << std::setprecision(1)
+        << ", p50 " << micros(percentile(0.5)) << " us"
+        << ", p99 " << micros(percentile(0.99)) << " us"
+        << ", p99.9 " << micros(percentile(0.999)) << " us"
+        << ", max " << micros(m_max) << " us";
+    return out.str();
+}
@@ -0,0 +1,37 @@
+#ifndef CHESS_LATENCYHISTOGRAM_H
+#define CHESS_LATENCYHISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Latency distribution in the style of an HDR histogram: log-linear buckets with 16
+// steps per power of two, so any percentile is within about 6% of the true value
+// from nanoseconds to minutes, in fixed memory and O(1) per sample. Not thread-safe.
+class LatencyHistogram {
+public:
+    void record(std::int64_t nanoseconds);
+    void reset();
+
+    std::uint64_t count() const { return m_count; }
+    std::int64_t max() const { return m_max; }
+    // Upper bound of the bucket reached by the given fraction of samples, e.g. 0.99
+    std::int64_t percentile(double fraction) const;
+
+    // "label: n 120, p50 41 us, p99 130 us, p99.9 410 us, max 512 us"
+    std::string summary(const std::string &label) const;
+
+private:
+    static constexpr int SubBucketBits = 4;
+    static constexpr int SubBuckets = 1 << SubBucketBits;
+    static constexpr int BucketCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+    static int bucketOf(std::uint64_t value);
+    static std::int64_t upperBound(int bucket);
+
+    std::array<std::uint64_t, BucketCount> m_buckets = {};
+    std::uint64_t m_count = 0;
+    std::int64_t m_max = 0;
+};
+
+#endif //CHESS_LATENCYHISTOGRAM_H
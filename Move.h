@@ -0,0 +1,64 @@
+#ifndef CHESS_MOVE_H
+#define CHESS_MOVE_H
+
+#include "Types.h"
+
+#include <cstdint>
+#include <string>
+
+// Castling moves are encoded as the king's two-square step
+enum class MoveType { Normal, Promotion, EnPassant, Castling };
+
+// Promotion pieces in the order of their 2-bit code, and the code of each PieceType
+constexpr PieceType PromotionPieces[4] = {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen};
+constexpr int PromotionCodes[PieceTypeCount] = {0, 2, 0, 1, 3, 0};
+
+// A move packed into 16 bits:
+//   bits  0-5   from square
+//   bits  6-11  to square
+//   bits 12-13  promotion piece code (see PromotionPieces)
+//   bits 14-15  MoveType
+// The all-zero value (a1a1) can never be legal and doubles as "no move".
+class Move {
+public:
+    // Left uninitialised so move buffers cost nothing to create; use Move::none() for "no move"
+    Move() = default;
+
+    constexpr Move(Square from, Square to, MoveType type = MoveType::Normal, PieceType promotion = PieceType::Knight)
+            : m_data(static_cast<std::uint16_t>(from | (to << 6) | (PromotionCodes[int(promotion)] << 12) | (int(type) << 14))) {}
+
+    static constexpr Move fromRaw(std::uint16_t data) {
+        Move move;
+        move.m_data = data;
+        return move;
+    }
+
+    static constexpr Move none() { return fromRaw(0); }
+
+    constexpr Square from() const { return m_data & 0x3f; }
+    constexpr Square to() const { return (m_data >> 6) & 0x3f; }
+    constexpr MoveType type() const { return MoveType(m_data >> 14); }
+    constexpr PieceType promotion() const { return PromotionPieces[(m_data >> 12) & 3]; }
+    constexpr std::uint16_t raw() const { return m_data; }
+    constexpr bool isNone() const { return m_data == 0; }
+
+    constexpr bool operator==(const Move &other) const = default;
+
+private:
+    std::uint16_t m_data;
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay packed into 16 bits");
+static_assert(Move(12, 28).to() == 28 && Move(52, 60, MoveType::Promotion, PieceType::Rook).promotion() == PieceType::Rook);
+
+// Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q"; "0000" for no move
+inline std::string moveToUci(Move move) {
+    if (move.isNone()) return "0000";
+
+    std::string text = {char('a' + colOf(move.from())), char('1' + rowOf(move.from())),
+                        char('a' + colOf(move.to())), char('1' + rowOf(move.to()))};
+    if (move.type() == MoveType::Promotion) text += "nbrq"[PromotionCodes[int(move.promotion())]];
+    return text;
+}
+
+#endif //CHESS_MOVE_H
@@ -0,0 +1,181 @@
+#include "MoveGen.h"
+#include "Stats.h"
+
+namespace {
+    const PieceType PromotionTypes[4] = {PieceType::Queen, PieceType::Rook, PieceType::Bishop, PieceType::Knight};
+
+    void addPawnMove(MoveList &list, Square from, Square to) {
+        if (rowOf(to) == 0 || rowOf(to) == 7) {
+            for (PieceType pt : PromotionTypes) list.add({from, to, MoveType::Promotion, pt});
+        } else {
+            list.add({from, to});
+        }
+    }
+
+    Bitboard pieceAttacks(PieceType pt, Square s, Bitboard occupied) {
+        switch (pt) {
+            case PieceType::Knight: return KnightAttacks[s];
+            case PieceType::Bishop: return bishopAttacks(s, occupied);
+            case PieceType::Rook: return rookAttacks(s, occupied);
+            case PieceType::Queen: return bishopAttacks(s, occupied) | rookAttacks(s, occupied);
+            default: return 0;
+        }
+    }
+
+    // En passant removes two pawns from one row, which can expose the king along it, so
+    // each candidate is verified against the sliders directly. Such moves are rare enough
+    // that this costs nothing, and it covers evasions too.
+    void generateEnPassant(const Position &pos, MoveList &list) {
+        Square ep = pos.epSquare();
+        if (ep == NoSquare) return;
+
+        Color us = pos.sideToMove(), them = ~us;
+        Square ksq = pos.kingSquare(us);
+        Square capturedSquare = ep - pawnPush(us);
+        Bitboard candidates = PawnAttacks[them][ep] & pos.pieces(us, PieceType::Pawn);
+        while (candidates) {
+            Square from = popLsb(candidates);
+            Bitboard occupied = (pos.pieces() ^ squareBB(from) ^ squareBB(capturedSquare)) | squareBB(ep);
+            Bitboard attackers = pos.attackersTo(ksq, occupied) & pos.pieces(them) & ~squareBB(capturedSquare);
+            if (!attackers) list.add({from, ep, MoveType::EnPassant});
+        }
+    }
+
+    // Non-king moves landing on `target`. Pinned pieces may only slide along the pin line.
+    void generatePieceMoves(const Position &pos, MoveList &list, Bitboard target) {
+        Color us = pos.sideToMove();
+        Square ksq = pos.kingSquare(us);
+        Bitboard occupied = pos.pieces();
+        Bitboard theirs = pos.pieces(~us);
+        Bitboard pinned = pos.pinned();
+        int up = pawnPush(us);
+        int startRow = us == White ? 1 : 6;
+
+        Bitboard pawns = pos.pieces(us, PieceType::Pawn);
+        while (pawns) {
+            Square from = popLsb(pawns);
+            Bitboard allowed = pinned & squareBB(from) ? target & LineBB[ksq][from] : target;
+
+            Square push = from + up;
+            if (!(occupied & squareBB(push))) {
+                if (allowed & squareBB(push)) addPawnMove(list, from, push);
+                Square doublePush = push + up;
+                if (rowOf(from) == startRow && !(occupied & squareBB(doublePush)) && (allowed & squareBB(doublePush))) {
+                    list.add({from, doublePush});
+                }
+            }
+
+            Bitboard captures = PawnAttacks[us][from] & theirs & allowed;
+            while (captures) addPawnMove(list, from, popLsb(captures));
+        }
+
+        generateEnPassant(pos, list);
+
+        for (PieceType pt : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
+            Bitboard movers = pos.pieces(us, pt);
+            if (pt == PieceType::Knight) movers &= ~pinned; // A pinned knight can never move
+            while (movers) {
+                Square from = popLsb(movers);
+                Bitboard attacks = pieceAttacks(pt, from, occupied) & target;
+                if (pinned & squareBB(from)) attacks &= LineBB[ksq][from];
+                while (attacks) list.add({from, popLsb(attacks)});
+            }
+        }
+    }
+
+    void generateKingMoves(const Position &pos, MoveList &list, Bitboard kingDanger) {
+        Color us = pos.sideToMove();
+        Square ksq = pos.kingSquare(us);
+        Bitboard targets = KingAttacks[ksq] & ~pos.pieces(us) & ~kingDanger;
+        while (targets) list.add({ksq, popLsb(targets)});
+    }
+
+    // Castling is only tried out of check; the squares the king crosses must be safe and
+    // everything between king and rook empty.
+    void generateCastling(const Position &pos, MoveList &list, Bitboard kingDanger) {
+        Color us = pos.sideToMove();
+        int row = us == White ? 0 : 7;
+        int kingSide = us == White ? WhiteKingSide : BlackKingSide;
+        int queenSide = us == White ? WhiteQueenSide : BlackQueenSide;
+        Square ksq = makeSquare(row, 4);
+        Bitboard occupied = pos.pieces();
+
+        if ((pos.castlingRights() & kingSide)
+            && !(BetweenBB[ksq][makeSquare(row, 7)] & occupied)
+            && !(BetweenBB[ksq][makeSquare(row, 7)] & kingDanger)) {
+            list.add({ksq, makeSquare(row, 6), MoveType::Castling});
+        }
+        if ((pos.castlingRights() & queenSide)
+            && !(BetweenBB[ksq][makeSquare(row, 0)] & occupied)
+            && !(BetweenBB[ksq][makeSquare(row, 1)] & kingDanger)) {
+            list.add({ksq, makeSquare(row, 2), MoveType::Castling});
+        }
+    }
+
+    // In check only the king may move, capture the checker or block its line
+    void generateEvasions(const Position &pos, MoveList &list, Bitboard kingDanger) {
+        generateKingMoves(pos, list, kingDanger);
+
+        Bitboard checkers = pos.checkers();
+        if (popcount(checkers) > 1) return; // Double check: king moves only
+
+        Square checker = lsb(checkers);
+        generatePieceMoves(pos, list, BetweenBB[pos.kingSquare(pos.sideToMove())][checker] | checkers);
+    }
+
+    void generateNonEvasions(const Position &pos, MoveList &list, Bitboard kingDanger) {
+        generateKingMoves(pos, list, kingDanger);
+        generateCastling(pos, list, kingDanger);
+        generatePieceMoves(pos, list, ~pos.pieces(pos.sideToMove()));
+    }
+}
+
+Bitboard attackedSquares(const Position &pos, Color by, Bitboard occupied) {
+    Bitboard attacked = 0;
+    Bitboard pawns = pos.pieces(by, PieceType::Pawn);
+    while (pawns) attacked |= PawnAttacks[by][popLsb(pawns)];
+    attacked |= KingAttacks[pos.kingSquare(by)];
+    for (PieceType pt : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
+        Bitboard attackers = pos.pieces(by, pt);
+        while (attackers) attacked |= pieceAttacks(pt, popLsb(attackers), occupied);
+    }
+    return attacked;
+}
+
+void generateLegalMoves(const Position &pos, MoveList &list) {
+    CHESS_STAT(MoveGenCalls);
+    list.count = 0;
+
+    // Remove our king from the occupancy so squares behind it on a checking ray count as attacked
+    Color us = pos.sideToMove();
+    Bitboard kingDanger = attackedSquares(pos, ~us, pos.pieces() ^ pos.pieces(us, PieceType::King));
+
+    if (pos.checkers()) {
+        generateEvasions(pos, list, kingDanger);
+    } else {
+        generateNonEvasions(pos, list, kingDanger);
+    }
+}
+
+GameResult gameResult(const Position &pos, const MoveList &legalMoves) {
+    // No moves decides the game even on the hundredth half-move
+    if (legalMoves.size() == 0) return pos.checkers() ? GameResult::Checkmate : GameResult::Stalemate;
+    if (pos.rule50() >= 100) return GameResult::FiftyMoves;
+    if (pos.isThreefoldRepetition()) return GameResult::Repetition;
+    if (pos.hasInsufficientMaterial()) return GameResult::InsufficientMaterial;
+    return GameResult::Ongoing;
+}
+
+std::uint64_t perft(Position &pos, int depth) {
+    MoveList list;
+    generateLegalMoves(pos, list);
+    if (depth <= 1) return depth == 1 ? list.size() : 1;
+
+    std::uint64_t nodes = 0;
+    for (Move move : list) {
+        pos.doMove(move);
+        nodes += perft(pos, depth - 1);
+        pos.undoMove(move);
+    }
+    return nodes;
+}
@@ -0,0 +1,44 @@
+#ifndef CHESS_MOVEGEN_H
+#define CHESS_MOVEGEN_H
+
+#include "Position.h"
+
+#include <cstdint>
+
+constexpr int MaxMoves = 256;
+
+// Fixed-capacity move buffer so generation never touches the heap
+struct MoveList {
+    Move moves[MaxMoves];
+    int count = 0;
+
+    void add(Move move) { moves[count++] = move; }
+    const Move *begin() const { return moves; }
+    const Move *end() const { return moves + count; }
+    int size() const { return count; }
+};
+
+// Squares attacked by the given side, with sliders looking through `occupied`
+Bitboard attackedSquares(const Position &pos, Color by, Bitboard occupied);
+
+// Produces only legal moves. Checkers and pins come precomputed from the position and
+// king-danger squares are computed once here, so no move has to be played to test it.
+void generateLegalMoves(const Position &pos, MoveList &list);
+
+enum class GameResult {
+    Ongoing,
+    Checkmate, // The side to move is mated
+    Stalemate,
+    FiftyMoves,
+    Repetition,
+    InsufficientMaterial
+};
+
+// Whether the game is over in pos. Takes the legal moves the caller already generated for
+// the position, so finding out never costs a second generation call.
+GameResult gameResult(const Position &pos, const MoveList &legalMoves);
+
+// Counts leaf nodes of the legal move tree; exercises doMove/undoMove for benchmarking
+std::uint64_t perft(Position &pos, int depth);
+
+#endif //CHESS_MOVEGEN_H
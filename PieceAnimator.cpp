@@ -0,0 +1,63 @@
+#include "PieceAnimator.h"
+
+#include <QEasingCurve>
+#include <QGraphicsItem>
+#include <QVariantAnimation>
+
+namespace {
+    // A frame this late means the event loop is busy; stop animating rather than add to it
+    constexpr int LateFrameMs = 100;
+}
+
+PieceAnimator::PieceAnimator(QObject *parent) : QObject(parent) {
+    m_animation = new QVariantAnimation(this);
+    m_animation->setStartValue(0.0);
+    m_animation->setEndValue(1.0);
+    m_animation->setEasingCurve(QEasingCurve::OutCubic);
+    connect(m_animation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
+        if (m_sinceFrame.isValid() && m_sinceFrame.restart() > LateFrameMs) {
+            finish();
+            return;
+        }
+        advance(value.toDouble());
+    });
+    connect(m_animation, &QVariantAnimation::finished, this, [this] { m_slides.clear(); });
+}
+
+void PieceAnimator::setDuration(int milliseconds) {
+    finish();
+    m_duration = milliseconds;
+}
+
+void PieceAnimator::slide(QGraphicsItem *item, const QPointF &to) {
+    m_slides.push_back({item, item->pos(), to});
+}
+
+void PieceAnimator::start() {
+    if (m_slides.empty()) return;
+
+    // Moves coming faster than they can be shown, e.g. a bullet game between engines,
+    // are not animated at all
+    bool tooSoon = m_sinceStart.isValid() && m_sinceStart.elapsed() < 2 * m_duration;
+    m_sinceStart.start();
+    if (m_duration == 0 || tooSoon) {
+        finish();
+        return;
+    }
+
+    m_sinceFrame.start();
+    m_animation->setDuration(m_duration);
+    m_animation->start();
+}
+
+void PieceAnimator::finish() {
+    m_animation->stop();
+    advance(1.0);
+    m_slides.clear();
+}
+
+void PieceAnimator::advance(double progress) {
+    for (const Slide &slide : m_slides) {
+        slide.item->setPos(slide.from + (slide.to - slide.from) * progress);
+    }
+}
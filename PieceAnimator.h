@@ -0,0 +1,51 @@
+#ifndef CHESS_PIECEANIMATOR_H
+#define CHESS_PIECEANIMATOR_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointF>
+
+#include <vector>
+
+class QGraphicsItem;
+class QVariantAnimation;
+
+// Slides pieces to their new squares. One animation drives every moving piece, so a move
+// that also shifts a rook, or a burst of quick moves, never runs more than one timer.
+// Animation gives way under load: moves arriving faster than it can show them, or frames
+// arriving late, put the pieces straight on their squares.
+class PieceAnimator : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PieceAnimator(QObject *parent = nullptr);
+
+    // Milliseconds per move; 0 turns animation off
+    void setDuration(int milliseconds);
+    int duration() const { return m_duration; }
+
+    // Queues a slide from the item's current position; start() runs the queued slides
+    void slide(QGraphicsItem *item, const QPointF &to);
+    void start();
+
+    // Puts every moving piece on its target at once
+    void finish();
+
+private:
+    void advance(double progress);
+
+    struct Slide {
+        QGraphicsItem *item;
+        QPointF from;
+        QPointF to;
+    };
+
+    std::vector<Slide> m_slides;
+    QVariantAnimation *m_animation;
+    int m_duration = 150;
+    // Time since the last start and since the last frame, to tell when to skip
+    QElapsedTimer m_sinceStart;
+    QElapsedTimer m_sinceFrame;
+};
+
+#endif //CHESS_PIECEANIMATOR_H
@@ -0,0 +1,64 @@
+#include "PieceAtlas.h"
+
+#include <QCoreApplication>
+#include <QFont>
+#include <QPainter>
+
+namespace {
+    // Indexed by PieceType: Pawn, Rook, Knight, Bishop, Queen, King. White pieces use the
+    // outlined set, black pieces the filled one.
+    const char *const WhiteSymbols[PieceTypeCount] = {"♙", "♖", "♘", "♗", "♕", "♔"};
+    const char *const BlackSymbols[PieceTypeCount] = {"♟", "♜", "♞", "♝", "♛", "♚"};
+
+    qreal atlasRatio = 0;
+    QPixmap atlas;
+    // One slice per Piece, cut from atlas whenever it is rendered
+    QPixmap glyphs[2 * PieceTypeCount];
+
+    // Pixmaps must not outlive the application; Qt calls this from its destructor, and a
+    // later application renders the atlas again
+    void release() {
+        atlas = QPixmap();
+        for (QPixmap &glyph : glyphs) glyph = QPixmap();
+        atlasRatio = 0;
+    }
+
+    void render(qreal ratio) {
+        if (atlasRatio == 0) qAddPostRoutine(release);
+        const int size = PieceAtlas::GlyphSize;
+        atlas = QPixmap(QSize(2 * PieceTypeCount * size, size) * ratio);
+        atlas.setDevicePixelRatio(ratio);
+        atlas.fill(Qt::transparent);
+
+        QPainter painter(&atlas);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setFont(QFont("Arial", 24));
+        for (Color c : {White, Black}) {
+            for (int pt = 0; pt < PieceTypeCount; ++pt) {
+                Piece p = makePiece(c, PieceType(pt));
+                painter.setPen(c == White ? Qt::black : Qt::white);
+                painter.drawText(QRect(p * size, 0, size, size), Qt::AlignCenter,
+                                 QString::fromUtf8((c == White ? WhiteSymbols : BlackSymbols)[pt]));
+            }
+        }
+        painter.end();
+
+        // copy() works in device pixels and drops the ratio
+        for (int p = 0; p < 2 * PieceTypeCount; ++p) {
+            glyphs[p] = atlas.copy(QRect(QPoint(p * size, 0) * ratio, QSize(size, size) * ratio));
+            glyphs[p].setDevicePixelRatio(ratio);
+        }
+        atlasRatio = ratio;
+    }
+}
+
+const QPixmap &PieceAtlas::glyph(PieceType type, bool isWhite) {
+    if (atlasRatio == 0) render(1.0);
+    return glyphs[makePiece(isWhite ? White : Black, type)];
+}
+
+bool PieceAtlas::setDevicePixelRatio(qreal ratio) {
+    if (ratio == atlasRatio) return false;
+    render(ratio);
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef CHESS_PIECEATLAS_H
+#define CHESS_PIECEATLAS_H
+
+#include <QPixmap>
+
+#include "Types.h"
+
+// The twelve piece glyphs, rendered once into a single pixmap at the screen's device
+// pixel ratio. Items paint a slice of it instead of laying out text every repaint.
+class PieceAtlas {
+public:
+    static constexpr int GlyphSize = 50; // Logical pixels, one board square
+
+    // The glyph cut from the atlas; items showing the same piece share its pixels
+    static const QPixmap &glyph(PieceType type, bool isWhite);
+
+    // Renders the atlas again if the ratio differs; returns whether it did
+    static bool setDevicePixelRatio(qreal ratio);
+};
+
+#endif //CHESS_PIECEATLAS_H
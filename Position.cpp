@@ -0,0 +1,503 @@
+#include "Position.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+
+namespace {
+    const char *const PieceChars = "PRNBQKprnbqk";
+    const char *const CastlingChars = "KQkq";
+    const char *const StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // Rights kept when a move touches a square; moving from or capturing on a king or
+    // rook home square clears the matching bits with a single AND.
+    constexpr std::array<int, 64> CastlingRightsMask = [] {
+        std::array<int, 64> mask{};
+        mask.fill(AllCastling);
+        mask[makeSquare(0, 0)] &= ~WhiteQueenSide;
+        mask[makeSquare(0, 7)] &= ~WhiteKingSide;
+        mask[makeSquare(0, 4)] &= ~(WhiteKingSide | WhiteQueenSide);
+        mask[makeSquare(7, 0)] &= ~BlackQueenSide;
+        mask[makeSquare(7, 7)] &= ~BlackKingSide;
+        mask[makeSquare(7, 4)] &= ~(BlackKingSide | BlackQueenSide);
+        return mask;
+    }();
+
+    std::string squareName(Square s) {
+        return {char('a' + colOf(s)), char('1' + rowOf(s))};
+    }
+
+    namespace Zobrist {
+        Key pieceSquare[12][64];
+        Key castling[16];
+        Key epFile[8];
+        Key side;
+    }
+
+    // Cuckoo tables holding the key difference of every reversible piece move on an empty
+    // board, so a cycle back to an earlier position shows up as a lookup of two keys' XOR
+    Key cuckoo[8192];
+    Move cuckooMove[8192];
+
+    constexpr int cuckooH1(Key key) { return int(key & 0x1fff); }
+    constexpr int cuckooH2(Key key) { return int((key >> 16) & 0x1fff); }
+
+    Bitboard emptyBoardAttacks(PieceType pt, Square s) {
+        switch (pt) {
+            case PieceType::Knight: return KnightAttacks[s];
+            case PieceType::Bishop: return bishopAttacks(s, 0);
+            case PieceType::Rook: return rookAttacks(s, 0);
+            case PieceType::Queen: return bishopAttacks(s, 0) | rookAttacks(s, 0);
+            case PieceType::King: return KingAttacks[s];
+            default: return 0;
+        }
+    }
+
+    // xorshift64* keeps the keys identical from run to run
+    Key nextRandom(Key &state) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+}
+
+void Position::init() {
+    Key state = 1070372;
+    for (auto &squares : Zobrist::pieceSquare) {
+        for (Key &k : squares) k = nextRandom(state);
+    }
+    for (Key &k : Zobrist::castling) k = nextRandom(state);
+    for (Key &k : Zobrist::epFile) k = nextRandom(state);
+    Zobrist::side = nextRandom(state);
+
+    // Both directions of a move share an entry, since their key differences are equal
+    std::fill(std::begin(cuckoo), std::end(cuckoo), 0);
+    std::fill(std::begin(cuckooMove), std::end(cuckooMove), Move::none());
+    for (int pc = 0; pc < 2 * PieceTypeCount; ++pc) {
+        for (Square s1 = 0; s1 < 64; ++s1) {
+            for (Square s2 = s1 + 1; s2 < 64; ++s2) {
+                if (!(emptyBoardAttacks(typeOf(Piece(pc)), s1) & squareBB(s2))) continue;
+
+                Move move(s1, s2);
+                Key key = Zobrist::pieceSquare[pc][s1] ^ Zobrist::pieceSquare[pc][s2] ^ Zobrist::side;
+                int slot = cuckooH1(key);
+                while (true) {
+                    std::swap(cuckoo[slot], key);
+                    std::swap(cuckooMove[slot], move);
+                    if (move.isNone()) break;
+                    slot = slot == cuckooH1(key) ? cuckooH2(key) : cuckooH1(key);
+                }
+            }
+        }
+    }
+}
+
+Position::Position() {
+    setStartPosition();
+}
+
+void Position::setStartPosition() {
+    setFen(StartFen);
+}
+
+void Position::clear() {
+    for (Bitboard &b : m_byType) b = 0;
+    m_byColor[White] = m_byColor[Black] = 0;
+    for (Piece &p : m_board) p = NoPiece;
+    m_sideToMove = White;
+    m_gamePly = 0;
+    m_stateIndex = 0;
+    m_states[0] = {};
+    st().epSquare = NoSquare;
+    st().captured = NoPiece;
+}
+
+PositionSnapshot Position::snapshot() const {
+    PositionSnapshot snapshot;
+    std::copy(std::begin(m_byType), std::end(m_byType), snapshot.byType);
+    std::copy(std::begin(m_byColor), std::end(m_byColor), snapshot.byColor);
+    std::copy(std::begin(m_board), std::end(m_board), snapshot.board);
+    snapshot.sideToMove = m_sideToMove;
+    snapshot.gamePly = m_gamePly;
+    snapshot.key = st().key;
+    snapshot.castlingRights = st().castlingRights;
+    snapshot.epSquare = st().epSquare;
+    snapshot.rule50 = st().rule50;
+    snapshot.repetition = st().repetition;
+    return snapshot;
+}
+
+void Position::restore(const PositionSnapshot &snapshot) {
+    std::copy(std::begin(snapshot.byType), std::end(snapshot.byType), m_byType);
+    std::copy(std::begin(snapshot.byColor), std::end(snapshot.byColor), m_byColor);
+    std::copy(std::begin(snapshot.board), std::end(snapshot.board), m_board);
+    m_sideToMove = snapshot.sideToMove;
+    m_gamePly = snapshot.gamePly;
+    m_stateIndex = 0;
+
+    StateInfo &state = st();
+    state = {};
+    state.key = snapshot.key;
+    state.castlingRights = snapshot.castlingRights;
+    state.epSquare = snapshot.epSquare;
+    state.rule50 = snapshot.rule50;
+    state.repetition = snapshot.repetition;
+    state.captured = NoPiece;
+    // The ring before this entry is stale; repetition scans must not reach into it
+    state.pliesFromNull = 0;
+    updateCheckInfo();
+}
+
+bool Position::setFen(const std::string &fen) {
+    std::istringstream in(fen);
+    std::string placement, side, castling = "-", ep = "-";
+    int rule50 = 0, fullMove = 1;
+    if (!(in >> placement >> side)) return false;
+    in >> castling >> ep >> rule50 >> fullMove;
+
+    clear();
+    int row = 7, col = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            --row;
+            col = 0;
+        } else if (std::isdigit(static_cast<unsigned char>(c))) {
+            col += c - '0';
+        } else {
+            const char *found = std::char_traits<char>::find(PieceChars, 12, c);
+            if (!found || row < 0 || col > 7) return false;
+            putPiece(Piece(found - PieceChars), makeSquare(row, col++));
+        }
+    }
+
+    m_sideToMove = side == "b" ? Black : White;
+    if (popcount(pieces(White, PieceType::King)) != 1 || popcount(pieces(Black, PieceType::King)) != 1) return false;
+    // Move generation relies on pawns never standing on the first or last rank, and on
+    // the side that just moved not having left its king in check
+    constexpr Bitboard BackRanks = 0xFF000000000000FFULL;
+    if (pieces(PieceType::Pawn) & BackRanks) return false;
+    if (attackersTo(kingSquare(~m_sideToMove), pieces()) & pieces(m_sideToMove)) return false;
+
+    StateInfo &state = st();
+    for (char c : castling) {
+        if (const char *found = std::char_traits<char>::find(CastlingChars, 4, c)) {
+            state.castlingRights |= 1 << (found - CastlingChars);
+        }
+    }
+    // Drop rights whose king or rook is no longer at home
+    for (Square s : {makeSquare(0, 0), makeSquare(0, 4), makeSquare(0, 7), makeSquare(7, 0), makeSquare(7, 4), makeSquare(7, 7)}) {
+        Piece expected = makePiece(rowOf(s) ? Black : White, colOf(s) == 4 ? PieceType::King : PieceType::Rook);
+        if (m_board[s] != expected) state.castlingRights &= CastlingRightsMask[s];
+    }
+
+    if (ep.size() == 2 && ep[0] >= 'a' && ep[0] <= 'h' && ep[1] >= '1' && ep[1] <= '8') {
+        Square epSquare = makeSquare(ep[1] - '1', ep[0] - 'a');
+        // Keep the square only if a pawn can really capture there
+        if (PawnAttacks[~m_sideToMove][epSquare] & pieces(m_sideToMove, PieceType::Pawn)) state.epSquare = epSquare;
+    }
+
+    state.rule50 = rule50;
+    m_gamePly = std::max(2 * (fullMove - 1), 0) + (m_sideToMove == Black);
+    state.key = computeKey();
+    updateCheckInfo();
+    return true;
+}
+
+std::string Position::fen() const {
+    std::string result;
+    for (int row = 7; row >= 0; --row) {
+        int empty = 0;
+        for (int col = 0; col < 8; ++col) {
+            Piece p = m_board[makeSquare(row, col)];
+            if (p == NoPiece) {
+                ++empty;
+                continue;
+            }
+            if (empty) result += char('0' + empty);
+            empty = 0;
+            result += PieceChars[p];
+        }
+        if (empty) result += char('0' + empty);
+        if (row) result += '/';
+    }
+    result += m_sideToMove == White ? " w " : " b ";
+
+    const StateInfo &state = st();
+    if (!state.castlingRights) result += '-';
+    for (int i = 0; i < 4; ++i) {
+        if (state.castlingRights & (1 << i)) result += CastlingChars[i];
+    }
+
+    result += ' ';
+    result += state.epSquare == NoSquare ? "-" : squareName(state.epSquare);
+    result += ' ' + std::to_string(state.rule50) + ' ' + std::to_string(1 + m_gamePly / 2);
+    return result;
+}
+
+void Position::putPiece(Piece piece, Square s) {
+    m_board[s] = piece;
+    m_byType[int(typeOf(piece))] |= squareBB(s);
+    m_byColor[colorOf(piece)] |= squareBB(s);
+}
+
+void Position::removePiece(Square s) {
+    Piece piece = m_board[s];
+    m_byType[int(typeOf(piece))] ^= squareBB(s);
+    m_byColor[colorOf(piece)] ^= squareBB(s);
+    m_board[s] = NoPiece;
+}
+
+Bitboard Position::attackersTo(Square s, Bitboard occupied) const {
+    Bitboard queens = pieces(PieceType::Queen);
+    return (PawnAttacks[Black][s] & pieces(White, PieceType::Pawn))
+         | (PawnAttacks[White][s] & pieces(Black, PieceType::Pawn))
+         | (KnightAttacks[s] & pieces(PieceType::Knight))
+         | (KingAttacks[s] & pieces(PieceType::King))
+         | (rookAttacks(s, occupied) & (pieces(PieceType::Rook) | queens))
+         | (bishopAttacks(s, occupied) & (pieces(PieceType::Bishop) | queens));
+}
+
+Key Position::computeKey() const {
+    Key key = m_sideToMove == Black ? Zobrist::side : 0;
+    for (Bitboard b = pieces(); b; ) {
+        Square s = popLsb(b);
+        key ^= Zobrist::pieceSquare[m_board[s]][s];
+    }
+    key ^= Zobrist::castling[st().castlingRights];
+    if (st().epSquare != NoSquare) key ^= Zobrist::epFile[colOf(st().epSquare)];
+    return key;
+}
+
+void Position::updateCheckInfo() {
+    Color us = m_sideToMove, them = ~us;
+    Square ksq = kingSquare(us);
+    Bitboard occupied = pieces();
+    StateInfo &state = st();
+
+    state.checkers = attackersTo(ksq, occupied) & pieces(them);
+
+    // A slider aimed at our king through exactly one of our pieces pins that piece
+    Bitboard queens = pieces(them, PieceType::Queen);
+    Bitboard snipers = (rookAttacks(ksq, 0) & (pieces(them, PieceType::Rook) | queens))
+                     | (bishopAttacks(ksq, 0) & (pieces(them, PieceType::Bishop) | queens));
+    state.pinned = 0;
+    while (snipers) {
+        Bitboard between = BetweenBB[ksq][popLsb(snipers)] & occupied;
+        if (popcount(between) == 1) state.pinned |= between & pieces(us);
+    }
+}
+
+bool Position::givesCheck(Move move) const {
+    Color us = m_sideToMove;
+    Square ksq = kingSquare(~us);
+    Square from = move.from(), to = move.to();
+    PieceType moved = move.type() == MoveType::Promotion ? move.promotion() : typeOf(m_board[from]);
+
+    if (moved == PieceType::Pawn && (PawnAttacks[us][to] & squareBB(ksq))) return true;
+    if (moved == PieceType::Knight && (KnightAttacks[to] & squareBB(ksq))) return true;
+
+    // Our sliders and the occupancy as they will be after the move
+    Bitboard occupied = (pieces() ^ squareBB(from)) | squareBB(to);
+    Bitboard queens = pieces(us, PieceType::Queen);
+    Bitboard diagonal = (pieces(us, PieceType::Bishop) | queens) & ~squareBB(from);
+    Bitboard straight = (pieces(us, PieceType::Rook) | queens) & ~squareBB(from);
+    if (moved == PieceType::Bishop || moved == PieceType::Queen) diagonal |= squareBB(to);
+    if (moved == PieceType::Rook || moved == PieceType::Queen) straight |= squareBB(to);
+
+    if (move.type() == MoveType::EnPassant) {
+        occupied ^= squareBB(to - pawnPush(us));
+    } else if (move.type() == MoveType::Castling) {
+        auto [rookFrom, rookTo] = castlingRookSquares(to);
+        occupied ^= squareBB(rookFrom) | squareBB(rookTo);
+        straight ^= squareBB(rookFrom) | squareBB(rookTo);
+    }
+
+    return (bishopAttacks(ksq, occupied) & diagonal) || (rookAttacks(ksq, occupied) & straight);
+}
+
+std::pair<Square, Square> Position::castlingRookSquares(Square kingTo) {
+    int row = rowOf(kingTo);
+    return colOf(kingTo) == 6 ? std::pair(makeSquare(row, 7), makeSquare(row, 5))
+                              : std::pair(makeSquare(row, 0), makeSquare(row, 3));
+}
+
+void Position::doMove(Move move) {
+    const StateInfo &prev = st();
+    m_stateIndex = (m_stateIndex + 1) % MaxStates;
+    StateInfo &state = st();
+
+    Color us = m_sideToMove, them = ~us;
+    Piece moving = m_board[move.from()];
+    Square capturedSquare = move.type() == MoveType::EnPassant ? move.to() - pawnPush(us) : move.to();
+
+#ifdef CHESS_COPY_MAKE
+    std::copy(std::begin(m_byType), std::end(m_byType), state.byType);
+    std::copy(std::begin(m_byColor), std::end(m_byColor), state.byColor);
+    std::copy(std::begin(m_board), std::end(m_board), state.board);
+#endif
+
+    Key key = prev.key ^ Zobrist::side ^ Zobrist::castling[prev.castlingRights];
+    if (prev.epSquare != NoSquare) key ^= Zobrist::epFile[colOf(prev.epSquare)];
+    state.rule50 = prev.rule50 + 1;
+
+    state.captured = m_board[capturedSquare];
+    if (state.captured != NoPiece) {
+        key ^= Zobrist::pieceSquare[state.captured][capturedSquare];
+        removePiece(capturedSquare);
+        state.rule50 = 0;
+    }
+
+    Piece placed = move.type() == MoveType::Promotion ? makePiece(us, move.promotion()) : moving;
+    key ^= Zobrist::pieceSquare[moving][move.from()] ^ Zobrist::pieceSquare[placed][move.to()];
+    removePiece(move.from());
+    putPiece(placed, move.to());
+
+    if (move.type() == MoveType::Castling) {
+        auto [rookFrom, rookTo] = castlingRookSquares(move.to());
+        Piece rook = makePiece(us, PieceType::Rook);
+        key ^= Zobrist::pieceSquare[rook][rookFrom] ^ Zobrist::pieceSquare[rook][rookTo];
+        removePiece(rookFrom);
+        putPiece(rook, rookTo);
+    }
+
+    state.castlingRights = prev.castlingRights & CastlingRightsMask[move.from()] & CastlingRightsMask[move.to()];
+    key ^= Zobrist::castling[state.castlingRights];
+
+    state.epSquare = NoSquare;
+    if (typeOf(moving) == PieceType::Pawn) {
+        state.rule50 = 0;
+        if (std::abs(move.to() - move.from()) == 16) {
+            Square passed = move.from() + pawnPush(us);
+            if (PawnAttacks[us][passed] & pieces(them, PieceType::Pawn)) {
+                state.epSquare = passed;
+                key ^= Zobrist::epFile[colOf(passed)];
+            }
+        }
+    }
+
+    state.key = key;
+    state.pliesFromNull = prev.pliesFromNull + 1;
+    m_sideToMove = them;
+    ++m_gamePly;
+    updateCheckInfo();
+    updateRepetition();
+}
+
+void Position::undoMove([[maybe_unused]] Move move) {
+    m_sideToMove = ~m_sideToMove;
+    --m_gamePly;
+    const StateInfo &state = st();
+
+#ifdef CHESS_COPY_MAKE
+    std::copy(std::begin(state.byType), std::end(state.byType), m_byType);
+    std::copy(std::begin(state.byColor), std::end(state.byColor), m_byColor);
+    std::copy(std::begin(state.board), std::end(state.board), m_board);
+#else
+    Color us = m_sideToMove;
+
+    if (move.type() == MoveType::Castling) {
+        auto [rookFrom, rookTo] = castlingRookSquares(move.to());
+        removePiece(rookTo);
+        putPiece(makePiece(us, PieceType::Rook), rookFrom);
+    }
+
+    Piece placed = m_board[move.to()];
+    removePiece(move.to());
+    putPiece(move.type() == MoveType::Promotion ? makePiece(us, PieceType::Pawn) : placed, move.from());
+
+    if (state.captured != NoPiece) {
+        putPiece(state.captured, move.type() == MoveType::EnPassant ? move.to() - pawnPush(us) : move.to());
+    }
+#endif
+
+    m_stateIndex = (m_stateIndex + MaxStates - 1) % MaxStates;
+}
+
+// Only positions since the last capture, pawn move or null move can repeat, and only
+// with the same side to move, so the scan steps back two plies at a time
+void Position::updateRepetition() {
+    StateInfo &state = st();
+    state.repetition = 0;
+    int end = std::min({state.rule50, state.pliesFromNull, MaxStates - 1});
+    for (int i = 4; i <= end; i += 2) {
+        const StateInfo &earlier = stateBack(i);
+        if (earlier.key == state.key) {
+            state.repetition = earlier.repetition ? -i : i;
+            return;
+        }
+    }
+}
+
+bool Position::isDraw(int ply) const {
+    if (st().rule50 >= 100 && !checkers()) return true;
+    return (st().repetition && st().repetition < ply) || hasInsufficientMaterial();
+}
+
+bool Position::hasInsufficientMaterial() const {
+    if (pieces(PieceType::Pawn) | pieces(PieceType::Rook) | pieces(PieceType::Queen)) return false;
+    if (popcount(pieces(PieceType::Knight) | pieces(PieceType::Bishop)) <= 1) return true;
+
+    constexpr Bitboard DarkSquares = 0xAA55AA55AA55AA55ULL;
+    Bitboard bishops = pieces(PieceType::Bishop);
+    return !pieces(PieceType::Knight) && (!(bishops & DarkSquares) || !(bishops & ~DarkSquares));
+}
+
+bool Position::hasUpcomingRepetition(int ply) const {
+    const StateInfo &state = st();
+    int end = std::min({state.rule50, state.pliesFromNull, MaxStates - 1});
+    if (end < 3) return false;
+
+    Bitboard occupied = pieces();
+    for (int i = 3; i <= end; i += 2) {
+        const StateInfo &earlier = stateBack(i);
+        Key moveKey = state.key ^ earlier.key;
+        int slot = cuckooH1(moveKey);
+        if (cuckoo[slot] != moveKey) {
+            slot = cuckooH2(moveKey);
+            if (cuckoo[slot] != moveKey) continue;
+        }
+
+        // The move must be playable now, with nothing in its way
+        Square s1 = cuckooMove[slot].from(), s2 = cuckooMove[slot].to();
+        if (BetweenBB[s1][s2] & occupied) continue;
+        if (ply > i) return true;
+
+        // Reaching a position from before the root needs our own piece to make the move,
+        // and that position must already have occurred twice
+        if (colorOf(m_board[m_board[s1] == NoPiece ? s2 : s1]) != m_sideToMove) continue;
+        if (earlier.repetition) return true;
+    }
+    return false;
+}
+
+void Position::doNullMove() {
+    const StateInfo &prev = st();
+    m_stateIndex = (m_stateIndex + 1) % MaxStates;
+    StateInfo &state = st();
+
+    Key key = prev.key ^ Zobrist::side;
+    if (prev.epSquare != NoSquare) key ^= Zobrist::epFile[colOf(prev.epSquare)];
+
+    // The board is untouched, so even copy-make builds have nothing to save
+    state.key = key;
+    state.castlingRights = prev.castlingRights;
+    state.epSquare = NoSquare;
+    state.rule50 = prev.rule50 + 1;
+    state.pliesFromNull = 0;
+    state.repetition = 0;
+    state.captured = NoPiece;
+
+    m_sideToMove = ~m_sideToMove;
+    ++m_gamePly;
+    updateCheckInfo();
+}
+
+void Position::undoNullMove() {
+    m_sideToMove = ~m_sideToMove;
+    --m_gamePly;
+    m_stateIndex = (m_stateIndex + MaxStates - 1) % MaxStates;
+}
@@ -0,0 +1,152 @@
+#ifndef CHESS_POSITION_H
+#define CHESS_POSITION_H
+
+#include "Bitboard.h"
+#include "Move.h"
+
+#include <array>
+#include <string>
+#include <utility>
+
+// Depth of the undo stack: enough for a long game plus the deepest search line. It is
+// used as a ring, so only the most recent MaxStates positions can be undone.
+constexpr int MaxStates = 1024;
+
+// Undo record for one position. doMove fills a fresh entry and undoMove just steps back,
+// so nothing here is ever allocated during search.
+struct StateInfo {
+    Key key;
+    int castlingRights;
+    Square epSquare; // Set only when an en-passant capture is actually available
+    int rule50;
+    int pliesFromNull;
+    // Plies back to the previous occurrence of this position since the last irreversible
+    // move, negated if that occurrence was itself a repetition; 0 if there is none
+    int repetition;
+    Piece captured;
+    Bitboard checkers;
+    Bitboard pinned;
+#ifdef CHESS_COPY_MAKE
+    // Copy-make keeps the board of the previous position so undo is a plain copy back
+    Bitboard byType[PieceTypeCount];
+    Bitboard byColor[2];
+    Piece board[64];
+#endif
+};
+
+// A position without its undo ring, a few hundred bytes where a Position holds the whole
+// ring, for keeping many positions around
+struct PositionSnapshot {
+    Bitboard byType[PieceTypeCount];
+    Bitboard byColor[2];
+    Piece board[64];
+    Color sideToMove;
+    int gamePly;
+    Key key;
+    int castlingRights;
+    Square epSquare;
+    int rule50;
+    int repetition;
+};
+
+// Core board state kept independent of the scene, so rules and search never have to
+// query QGraphicsItems.
+class Position {
+public:
+    // Fills the Zobrist keys and cuckoo tables; must run once, after Bitboards::init()
+    // and before any Position is used
+    static void init();
+
+    Position();
+
+    void setStartPosition();
+    bool setFen(const std::string &fen);
+    std::string fen() const;
+
+    // Restoring a snapshot starts a fresh undo ring, as setFen does: moves before it can't
+    // be undone, and repetitions of positions before it aren't seen
+    PositionSnapshot snapshot() const;
+    void restore(const PositionSnapshot &snapshot);
+
+    Color sideToMove() const { return m_sideToMove; }
+    Piece pieceOn(Square s) const { return m_board[s]; }
+
+    Bitboard pieces() const { return m_byColor[White] | m_byColor[Black]; }
+    Bitboard pieces(Color c) const { return m_byColor[c]; }
+    Bitboard pieces(PieceType pt) const { return m_byType[int(pt)]; }
+    Bitboard pieces(Color c, PieceType pt) const { return m_byColor[c] & m_byType[int(pt)]; }
+    Square kingSquare(Color c) const { return lsb(pieces(c, PieceType::King)); }
+
+    Key key() const { return st().key; }
+    int castlingRights() const { return st().castlingRights; }
+    Square epSquare() const { return st().epSquare; }
+    int rule50() const { return st().rule50; }
+    int gamePly() const { return m_gamePly; }
+    const StateInfo &state() const { return st(); }
+
+    // Rook start and end squares for the castling move landing the king on kingTo
+    static std::pair<Square, Square> castlingRookSquares(Square kingTo);
+
+    // Check information for the side to move, refreshed once per position by doMove
+    Bitboard checkers() const { return st().checkers; }
+    Bitboard pinned() const { return st().pinned; }
+
+    Bitboard attackersTo(Square s, Bitboard occupied) const;
+
+    // Fifty-move rule, repetition or dead material. Inside a search, one repetition of a
+    // position reached after the root (ply plies up) is enough; before it a threefold
+    // repetition is needed. A fifty-move position in check may be mate, which only the
+    // move generator can tell.
+    bool isDraw(int ply) const;
+    bool isThreefoldRepetition() const { return st().repetition < 0; }
+
+    // Neither side can ever mate: bare kings, a single minor piece, or bishops that all
+    // stand on squares of one colour
+    bool hasInsufficientMaterial() const;
+
+    // True if the side to move has a reversible move back into an earlier position,
+    // so the score is at least a draw. Found with cuckoo tables, without generating moves.
+    bool hasUpcomingRepetition(int ply) const;
+
+    bool isCapture(Move move) const { return m_board[move.to()] != NoPiece || move.type() == MoveType::EnPassant; }
+
+    // Whether a legal move checks the opponent, directly or by uncovering a slider,
+    // answered without playing it
+    bool givesCheck(Move move) const;
+
+    // Plays a move produced by the legal move generator, and takes it back again.
+    // undoMove must be given the move that was last played.
+    void doMove(Move move);
+    void undoMove(Move move);
+
+    // Passes the turn without moving; only for null-move pruning, never while in check
+    void doNullMove();
+    void undoNullMove();
+
+    // True if c has anything besides pawns and the king
+    bool hasNonPawnMaterial(Color c) const {
+        return pieces(c) & ~(pieces(PieceType::Pawn) | pieces(PieceType::King));
+    }
+
+private:
+    StateInfo &st() { return m_states[m_stateIndex]; }
+    const StateInfo &st() const { return m_states[m_stateIndex]; }
+    const StateInfo &stateBack(int plies) const { return m_states[(m_stateIndex + MaxStates - plies) % MaxStates]; }
+
+    void clear();
+    void putPiece(Piece piece, Square s);
+    void removePiece(Square s);
+    void updateCheckInfo();
+    void updateRepetition();
+    Key computeKey() const;
+
+    Bitboard m_byType[PieceTypeCount];
+    Bitboard m_byColor[2];
+    Piece m_board[64];
+    Color m_sideToMove;
+    int m_gamePly;
+    std::array<StateInfo, MaxStates> m_states;
+    int m_stateIndex;
+};
+
+#endif //CHESS_POSITION_H
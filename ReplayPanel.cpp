@@ -0,0 +1,99 @@
+#include "ReplayPanel.h"
+
+#include "ChessBoard.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSignalBlocker>
+#include <QSlider>
+#include <QVBoxLayout>
+
+ReplayPanel::ReplayPanel(ChessBoard *board, QWidget *parent) : QWidget(parent), m_board(board) {
+    QPushButton *openButton = new QPushButton("Open game...", this);
+    QPushButton *saveButton = new QPushButton("Save game...", this);
+    m_slider = new QSlider(Qt::Horizontal, this);
+    m_slider->setRange(0, 0);
+    m_firstButton = new QPushButton("|<", this);
+    m_previousButton = new QPushButton("<", this);
+    m_nextButton = new QPushButton(">", this);
+    m_lastButton = new QPushButton(">|", this);
+    m_plyLabel = new QLabel(this);
+
+    QHBoxLayout *fileLayout = new QHBoxLayout;
+    fileLayout->addWidget(openButton);
+    fileLayout->addWidget(saveButton);
+    QHBoxLayout *stepLayout = new QHBoxLayout;
+    stepLayout->addWidget(m_firstButton);
+    stepLayout->addWidget(m_previousButton);
+    stepLayout->addWidget(m_nextButton);
+    stepLayout->addWidget(m_lastButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(fileLayout);
+    layout->addWidget(m_slider);
+    layout->addLayout(stepLayout);
+    layout->addWidget(m_plyLabel);
+    setFixedWidth(220);
+
+    connect(openButton, &QPushButton::clicked, this, &ReplayPanel::openGame);
+    connect(saveButton, &QPushButton::clicked, this, &ReplayPanel::saveGame);
+    connect(m_slider, &QSlider::valueChanged, this, &ReplayPanel::seek);
+    connect(m_firstButton, &QPushButton::clicked, this, [this] { m_slider->setValue(0); });
+    connect(m_previousButton, &QPushButton::clicked, this, [this] { m_slider->setValue(m_slider->value() - 1); });
+    connect(m_nextButton, &QPushButton::clicked, this, [this] { m_slider->setValue(m_slider->value() + 1); });
+    connect(m_lastButton, &QPushButton::clicked, this, [this] { m_slider->setValue(m_slider->maximum()); });
+
+    updateLabel();
+}
+
+void ReplayPanel::openGame() {
+    QString path = QFileDialog::getOpenFileName(this, "Open game", QString(), "Games (*.txt *.game);;All files (*)");
+    if (path.isEmpty()) return;
+
+    QFile file(path);
+    GameRecord record;
+    if (!file.open(QFile::ReadOnly | QFile::Text) || !record.load(file.readAll().toStdString())) {
+        QMessageBox::warning(this, "Open game", "Could not read a game from " + path);
+        return;
+    }
+
+    m_record = std::move(record);
+    {
+        // Open at the final position with a single seek
+        QSignalBlocker blocker(m_slider);
+        m_slider->setRange(0, m_record.length());
+        m_slider->setValue(m_record.length());
+    }
+    seek(m_record.length());
+}
+
+void ReplayPanel::saveGame() {
+    QString path = QFileDialog::getSaveFileName(this, "Save game", QString(), "Games (*.txt *.game)");
+    if (path.isEmpty()) return;
+
+    GameRecord record(m_board->startPosition(), m_board->playedMoves());
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text) || file.write(QByteArray::fromStdString(record.save())) < 0) {
+        QMessageBox::warning(this, "Save game", "Could not write " + path);
+    }
+}
+
+void ReplayPanel::seek(int ply) {
+    Position position;
+    m_record.positionAt(ply, position);
+    m_board->jumpTo(position);
+    updateLabel();
+    emit jumped();
+}
+
+void ReplayPanel::updateLabel() {
+    m_plyLabel->setText(QString("Ply %1 of %2").arg(m_slider->value()).arg(m_record.length()));
+    m_firstButton->setEnabled(m_slider->value() > 0);
+    m_previousButton->setEnabled(m_slider->value() > 0);
+    m_nextButton->setEnabled(m_slider->value() < m_record.length());
+    m_lastButton->setEnabled(m_slider->value() < m_record.length());
+}
@@ -0,0 +1,44 @@
+#ifndef CHESS_REPLAYPANEL_H
+#define CHESS_REPLAYPANEL_H
+
+#include <QWidget>
+
+#include "GameRecord.h"
+
+class ChessBoard;
+class QLabel;
+class QPushButton;
+class QSlider;
+
+// Opens a stored game and scrubs through it. Seeking starts from the nearest keyframe of
+// the record, and the board only touches the squares that differ from what it shows.
+class ReplayPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit ReplayPanel(ChessBoard *board, QWidget *parent = nullptr);
+
+public slots:
+    void openGame();
+    void saveGame();
+    void seek(int ply);
+
+signals:
+    // The board was set to a position of the loaded game
+    void jumped();
+
+private:
+    void updateLabel();
+
+    ChessBoard *m_board;
+    GameRecord m_record;
+
+    QSlider *m_slider;
+    QPushButton *m_firstButton;
+    QPushButton *m_previousButton;
+    QPushButton *m_nextButton;
+    QPushButton *m_lastButton;
+    QLabel *m_plyLabel;
+};
+
+#endif //CHESS_REPLAYPANEL_H
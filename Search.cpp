@@ -0,0 +1,649 @@
+#include "Search.h"
+#include "Evaluate.h"
+#include "Stats.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// A root move's line from the last completed iteration
+struct RootLine {
+    int score = 0;
+    int pvLength = 0;
+    Move pv[MaxPly];
+};
+
+// Per-thread search state. Everything a node needs lives here or on the stack, so the
+// search itself never allocates.
+class SearchWorker {
+public:
+    SearchWorker(Engine &engine, int index) : m_engine(engine), m_index(index) {}
+
+    void run(const Position &root, const SearchLimits &limits);
+
+    std::atomic<std::uint64_t> nodes{0};
+    int completedDepth = 0;
+    int selDepth = 0;
+    Move bestMove = Move::none();
+    GameResult rootResult = GameResult::Ongoing;
+    RootLine lines[MaxMoves]; // Best first
+    int lineCount = 0;
+
+private:
+    int search(int alpha, int beta, int depth, int ply);
+    int qsearch(int alpha, int beta, int ply);
+    void scoreMoves(const MoveList &list, int *scores, Move ttMove, int ply) const;
+    static Move pickNext(MoveList &list, int *scores, int index);
+    void countNode();
+    bool stopped() const { return m_engine.m_stop.load(std::memory_order_relaxed); }
+
+    Engine &m_engine;
+    int m_index;
+    SearchLimits m_limits;
+    Position m_pos;
+    Move m_pvTable[MaxPly][MaxPly];
+    int m_pvLength[MaxPly];
+    Move m_killers[MaxPly][2];
+    int m_history[2][64][64] = {}; // Starts at zero, then aged at the start of each search
+
+    // Move played at each ply of the current line; none for a null move
+    Move m_currentMove[MaxPly];
+    // Move skipped at a ply while testing whether the TT move is singular
+    Move m_excludedMove[MaxPly];
+    int m_nullMoveMinPly = 0;
+
+    // MultiPV: each line is searched with the root moves of the better lines excluded
+    RootLine m_newLines[MaxMoves];
+    int m_excludedCount = 0;
+    bool excludedAtRoot(Move move) const;
+};
+
+namespace {
+    // Mate scores are stored relative to the node so they stay valid at any ply
+    int scoreToTT(int score, int ply) {
+        return score >= MateInMaxPly ? score + ply : score <= -MateInMaxPly ? score - ply : score;
+    }
+
+    int scoreFromTT(int score, int ply) {
+        return score >= MateInMaxPly ? score - ply : score <= -MateInMaxPly ? score + ply : score;
+    }
+}
+
+void SearchWorker::countNode() {
+    nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Only the main thread watches the clock; helpers follow its stop flag
+    if (m_index == 0 && m_limits.moveTimeMs && !m_limits.infinite
+        && (nodes.load(std::memory_order_relaxed) & 1023) == 0
+        && !m_engine.m_pondering.load(std::memory_order_relaxed)
+        && m_engine.clockMs() >= m_limits.moveTimeMs) {
+        m_engine.m_stop = true;
+    }
+}
+
+bool SearchWorker::excludedAtRoot(Move move) const {
+    for (int i = 0; i < m_excludedCount; ++i) {
+        if (m_newLines[i].pv[0] == move) return true;
+    }
+    return false;
+}
+
+void SearchWorker::scoreMoves(const MoveList &list, int *scores, Move ttMove, int ply) const {
+    Color us = m_pos.sideToMove();
+    for (int i = 0; i < list.size(); ++i) {
+        Move move = list.moves[i];
+        if (move == ttMove) {
+            scores[i] = 1 << 30;
+        } else if (m_pos.isCapture(move)) {
+            // Most valuable victim, least valuable attacker
+            Piece victim = m_pos.pieceOn(move.to());
+            int victimValue = victim == NoPiece ? PieceValues[int(PieceType::Pawn)] : PieceValues[int(typeOf(victim))];
+            scores[i] = (1 << 28) + victimValue * 16 - PieceValues[int(typeOf(m_pos.pieceOn(move.from())))] / 16;
+        } else if (move.type() == MoveType::Promotion) {
+            scores[i] = (1 << 27) + PieceValues[int(move.promotion())];
+        } else if (move == m_killers[ply][0] || move == m_killers[ply][1]) {
+            scores[i] = 1 << 26;
+        } else {
+            scores[i] = m_history[us][move.from()][move.to()];
+        }
+    }
+}
+
+// Selection sort step: most nodes cut off after a few moves, so sorting lazily is cheaper
+Move SearchWorker::pickNext(MoveList &list, int *scores, int index) {
+    int best = index;
+    for (int i = index + 1; i < list.size(); ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    std::swap(list.moves[index], list.moves[best]);
+    std::swap(scores[index], scores[best]);
+    return list.moves[index];
+}
+
+void SearchWorker::run(const Position &root, const SearchLimits &limits) {
+    m_pos = root;
+    m_limits = limits;
+    nodes = 0;
+    completedDepth = 0;
+    lineCount = 0;
+    bestMove = Move::none();
+    std::memset(m_killers, 0, sizeof(m_killers));
+    std::fill(std::begin(m_excludedMove), std::end(m_excludedMove), Move::none());
+    m_nullMoveMinPly = 0;
+    for (auto &side : m_history) {
+        for (auto &from : side) {
+            for (int &value : from) value /= 8;
+        }
+    }
+
+    MoveList rootMoves;
+    generateLegalMoves(m_pos, rootMoves);
+    rootResult = gameResult(m_pos, rootMoves);
+    if (rootMoves.size() == 0) return;
+    bestMove = rootMoves.moves[0];
+
+    int maxDepth = limits.depth > 0 ? std::min(limits.depth, MaxPly - 1) : MaxPly - 1;
+    int multiPV = std::clamp(limits.multiPV, 1, rootMoves.size());
+
+    // Odd helpers start one ply deeper so the threads spread over different depths
+    for (int depth = 1 + (m_index % 2); depth <= maxDepth; ++depth) {
+        Trace::Scope iteration("iteration", "depth", depth);
+        selDepth = 0;
+
+        // The lines share the TT and move ordering, so each extra line is mostly TT hits
+        for (m_excludedCount = 0; m_excludedCount < multiPV; ++m_excludedCount) {
+            RootLine &line = m_newLines[m_excludedCount];
+            line.score = search(-InfiniteScore, InfiniteScore, depth, 0);
+            if (stopped()) break;
+
+            line.pvLength = m_pvLength[0];
+            std::copy(m_pvTable[0], m_pvTable[0] + line.pvLength, line.pv);
+        }
+        if (stopped()) break;
+
+        // A later line can come out ahead when deeper lines see more
+        std::stable_sort(m_newLines, m_newLines + multiPV, [](const RootLine &a, const RootLine &b) { return a.score > b.score; });
+        std::copy(m_newLines, m_newLines + multiPV, lines);
+        lineCount = multiPV;
+        completedDepth = depth;
+        bestMove = lines[0].pv[0];
+
+        if (m_index == 0) m_engine.reportIteration(*this);
+    }
+    m_excludedCount = 0;
+}
+
+int SearchWorker::search(int alpha, int beta, int depth, int ply) {
+    m_pvLength[ply] = ply;
+
+    // A move back into an earlier position is on the board: we can hold a draw at least
+    if (ply > 0 && alpha < 0 && m_pos.hasUpcomingRepetition(ply)) {
+        alpha = 0;
+        if (alpha >= beta) return alpha;
+    }
+
+    if (depth <= 0) return qsearch(alpha, beta, ply);
+    if (stopped()) return 0;
+
+    countNode();
+    CHESS_STAT(Nodes);
+    if (ply > 0 && m_pos.isDraw(ply)) return 0;
+    if (ply >= MaxPly - 1) return evaluate(m_pos);
+
+    const SearchParams &params = m_engine.m_params;
+    bool pvNode = beta - alpha > 1;
+    bool inCheck = m_pos.checkers();
+    Move excluded = m_excludedMove[ply];
+
+    // A singular verification search is a different question about the same position,
+    // so it must neither take nor leave a TT answer
+    TTEntry entry{};
+    bool ttHit = excluded.isNone() && m_engine.m_tt.probe(m_pos.key(), entry);
+    Move ttMove = ttHit ? entry.move : Move::none();
+    int ttScore = ttHit ? scoreFromTT(entry.score, ply) : 0;
+    if (ttHit && !pvNode && ply > 0 && entry.depth >= depth) {
+        if (entry.bound == Bound::Exact
+            || (entry.bound == Bound::Lower && ttScore >= beta)
+            || (entry.bound == Bound::Upper && ttScore <= alpha)) {
+            return ttScore;
+        }
+    }
+
+    MoveList list;
+    generateLegalMoves(m_pos, list);
+    if (list.size() == 0) return inCheck ? -MateScore + ply : 0;
+    if (ply > 0 && m_pos.rule50() >= 100) return 0;
+
+    int staticEval = inCheck ? -InfiniteScore : evaluate(m_pos);
+    bool pruneable = !pvNode && !inCheck && excluded.isNone() && std::abs(beta) < MateInMaxPly;
+
+    // Reverse futility: far enough above beta that the opponent can't catch up in time
+    if (params.reverseFutility && pruneable && depth <= params.reverseFutilityDepth
+        && staticEval - params.reverseFutilityMargin * depth >= beta) {
+        return staticEval;
+    }
+
+    // Razoring: far below alpha near the leaves, so only tactics can help
+    if (params.razoring && pruneable && depth <= params.razoringDepth
+        && staticEval + params.razoringMargin * depth < alpha) {
+        int score = qsearch(alpha, alpha + 1, ply);
+        if (score <= alpha) return score;
+    }
+
+    // Null move: if passing still fails high, a real move will too. Not twice in a row,
+    // and not without pieces, where zugzwang makes passing look too good.
+    if (params.nullMove && pruneable && depth >= params.nullMoveMinDepth && staticEval >= beta
+        && ply >= m_nullMoveMinPly && !(ply > 0 && m_currentMove[ply - 1].isNone())
+        && m_pos.hasNonPawnMaterial(m_pos.sideToMove())) {
+        int reduction = params.nullMoveReduction + depth / params.nullMoveDepthDivisor
+                      + std::min((staticEval - beta) / 200, 3);
+
+        m_currentMove[ply] = Move::none();
+        m_pos.doNullMove();
+        int score = -search(-beta, -beta + 1, depth - 1 - reduction, ply + 1);
+        m_pos.undoNullMove();
+        if (stopped()) return 0;
+
+        if (score >= beta) {
+            // Unproven mates from a pass aren't trustworthy
+            if (score >= MateInMaxPly) score = beta;
+            if (depth < params.nullMoveVerifyDepth) return score;
+
+            // Deep cutoffs are verified without null moves for the next few plies. A nested
+            // verification hands the outer one's window back when it is done.
+            int savedMinPly = m_nullMoveMinPly;
+            m_nullMoveMinPly = ply + 3 * (depth - reduction) / 4;
+            int verified = search(beta - 1, beta, depth - reduction, ply);
+            m_nullMoveMinPly = savedMinPly;
+            if (verified >= beta) return score;
+        }
+    }
+
+    // Singular extension: if every alternative to the TT move fails well below its score,
+    // the TT move is forced and gets searched one ply deeper
+    int singularExtension = 0;
+    if (params.singularExtensions && ply > 0 && depth >= params.singularDepth && excluded.isNone()
+        && !ttMove.isNone() && entry.bound != Bound::Upper && entry.depth >= depth - 3
+        && std::abs(ttScore) < MateInMaxPly) {
+        int singularBeta = ttScore - params.singularMargin * depth;
+        m_excludedMove[ply] = ttMove;
+        int score = search(singularBeta - 1, singularBeta, (depth - 1) / 2, ply);
+        m_excludedMove[ply] = Move::none();
+        if (stopped()) return 0;
+        if (score < singularBeta) singularExtension = 1;
+    }
+
+    // Check extension
+    if (inCheck) ++depth;
+
+    int scores[MaxMoves];
+    scoreMoves(list, scores, ttMove, ply);
+
+    int originalAlpha = alpha;
+    int bestScore = -InfiniteScore;
+    Move best = Move::none();
+    int searched = 0;
+    int quietsSearched = 0;
+
+    for (int i = 0; i < list.size(); ++i) {
+        Move move = pickNext(list, scores, i);
+        if (move == excluded || (ply == 0 && excludedAtRoot(move))) continue;
+        bool quiet = !m_pos.isCapture(move) && move.type() != MoveType::Promotion;
+        bool killer = move == m_killers[ply][0] || move == m_killers[ply][1];
+
+        bool givesCheck = m_pos.givesCheck(move);
+
+        // Quiet moves late in the list at shallow depth rarely matter unless they check.
+        // Something must already have been searched so a mate isn't missed. Decided before
+        // the move is made, so a pruned move costs no make/unmake.
+        bool lateQuiet = quiet && !inCheck && !givesCheck && !pvNode && searched > 0 && bestScore > -MateInMaxPly;
+        if (lateQuiet && params.futility && depth <= params.futilityDepth
+            && staticEval + params.futilityMargin * depth <= alpha) {
+            continue;
+        }
+        if (lateQuiet && params.lateMovePruning && depth <= params.lmpDepth
+            && quietsSearched >= params.lmpBase + depth * depth) {
+            continue;
+        }
+
+        m_currentMove[ply] = move;
+        m_pos.doMove(move);
+
+        int newDepth = depth - 1 + (move == ttMove ? singularExtension : 0);
+        int score;
+        if (searched == 0) {
+            score = -search(-beta, -alpha, newDepth, ply + 1);
+        } else {
+            // Late quiet moves are first searched shallower and only re-searched if they surprise
+            int reduction = 0;
+            if (params.lateMoveReductions && depth >= 3 && quiet && !inCheck && !givesCheck) {
+                reduction = m_engine.m_reductions[std::min(depth, 63)][std::min(searched, 63)];
+                if (pvNode) --reduction;
+                if (killer) --reduction;
+                reduction = std::clamp(reduction, 0, newDepth - 1);
+            }
+
+            // Principal variation search: prove the move is worse with a null window first
+            score = -search(-alpha - 1, -alpha, newDepth - reduction, ply + 1);
+            if (reduction > 0 && score > alpha) score = -search(-alpha - 1, -alpha, newDepth, ply + 1);
+            if (score > alpha && score < beta) score = -search(-beta, -alpha, newDepth, ply + 1);
+        }
+        m_pos.undoMove(move);
+        ++searched;
+        if (quiet) ++quietsSearched;
+
+        if (stopped()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            best = move;
+            if (score > alpha) {
+                alpha = score;
+                m_pvTable[ply][ply] = move;
+                std::copy(m_pvTable[ply + 1] + ply + 1, m_pvTable[ply + 1] + m_pvLength[ply + 1], m_pvTable[ply] + ply + 1);
+                m_pvLength[ply] = std::max(m_pvLength[ply + 1], ply + 1);
+
+                if (score >= beta) {
+                    CHESS_STAT_CUTOFF(searched - 1);
+                    if (quiet) {
+                        if (m_killers[ply][0] != move) {
+                            m_killers[ply][1] = m_killers[ply][0];
+                            m_killers[ply][0] = move;
+                        }
+                        int &history = m_history[m_pos.sideToMove()][move.from()][move.to()];
+                        history = std::min(history + depth * depth, 1 << 20);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Only the excluded move was legal: report a fail low so it counts as singular
+    if (searched == 0) return alpha;
+
+    // The root entry belongs to the best line; lower lines would overwrite its move
+    if ((ply > 0 || m_excludedCount == 0) && excluded.isNone()) {
+        Bound bound = bestScore >= beta ? Bound::Lower : bestScore > originalAlpha ? Bound::Exact : Bound::Upper;
+        m_engine.m_tt.store(m_pos.key(), best, scoreToTT(bestScore, ply), depth, bound);
+    }
+    return bestScore;
+}
+
+int SearchWorker::qsearch(int alpha, int beta, int ply) {
+    m_pvLength[ply] = ply;
+    if (stopped()) return 0;
+
+    countNode();
+    CHESS_STAT(QNodes);
+    selDepth = std::max(selDepth, ply);
+    if (m_pos.isDraw(ply)) return 0;
+    if (ply >= MaxPly - 1) return evaluate(m_pos);
+
+    bool inCheck = m_pos.checkers();
+    int bestScore = -InfiniteScore;
+    if (!inCheck) {
+        bestScore = evaluate(m_pos);
+        if (bestScore >= beta) return bestScore;
+        alpha = std::max(alpha, bestScore);
+    }
+
+    MoveList list;
+    generateLegalMoves(m_pos, list);
+    if (inCheck && list.size() == 0) return -MateScore + ply;
+
+    int scores[MaxMoves];
+    scoreMoves(list, scores, Move::none(), ply);
+
+    for (int i = 0; i < list.size(); ++i) {
+        Move move = pickNext(list, scores, i);
+
+        // Out of check only captures and queen promotions are worth resolving
+        bool tactical = m_pos.isCapture(move) || (move.type() == MoveType::Promotion && move.promotion() == PieceType::Queen);
+        if (!inCheck && !tactical) continue;
+
+        m_pos.doMove(move);
+        int score = -qsearch(-beta, -alpha, ply + 1);
+        m_pos.undoMove(move);
+
+        if (stopped()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                m_pvTable[ply][ply] = move;
+                std::copy(m_pvTable[ply + 1] + ply + 1, m_pvTable[ply + 1] + m_pvLength[ply + 1], m_pvTable[ply] + ply + 1);
+                m_pvLength[ply] = std::max(m_pvLength[ply + 1], ply + 1);
+                if (score >= beta) break;
+            }
+        }
+    }
+    return bestScore;
+}
+
+Engine::Engine(int threads, int hashMegabytes) {
+    m_tt.resize(hashMegabytes);
+    setParams(SearchParams{});
+    startThreads(threads);
+}
+
+Engine::~Engine() {
+    stopThreads();
+}
+
+void Engine::startThreads(int threads) {
+    threads = std::max(threads, 1);
+    m_quit = false;
+    m_generation = 0;
+    for (int i = 0; i < threads; ++i) m_workers.push_back(std::make_unique<SearchWorker>(*this, i));
+    m_mainThread = std::thread(&Engine::mainLoop, this);
+    for (int i = 1; i < threads; ++i) m_helperThreads.emplace_back(&Engine::helperLoop, this, i);
+}
+
+void Engine::stopThreads() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+        m_pending.reset();
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_mainThread.joinable()) m_mainThread.join();
+    for (std::thread &thread : m_helperThreads) thread.join();
+    m_helperThreads.clear();
+    m_workers.clear();
+}
+
+void Engine::setThreads(int threads) {
+    stop();
+    waitForIdle();
+    stopThreads();
+    startThreads(threads);
+}
+
+void Engine::setHashSize(int megabytes) {
+    stop();
+    waitForIdle();
+    Trace::Scope scope("tt resize", "megabytes", megabytes);
+    m_tt.resize(std::max(megabytes, 1));
+}
+
+void Engine::clearHash() {
+    stop();
+    waitForIdle();
+    m_tt.clear();
+}
+
+void Engine::setParams(const SearchParams &params) {
+    stop();
+    waitForIdle();
+    m_params = params;
+    for (int depth = 0; depth < 64; ++depth) {
+        for (int moveNumber = 0; moveNumber < 64; ++moveNumber) {
+            double reduction = depth && moveNumber ? std::log(depth) * std::log(moveNumber) * 100 / params.lmrDivisor : 0;
+            m_reductions[depth][moveNumber] = int(params.lmrBase / 100.0 + reduction);
+        }
+    }
+}
+
+std::uint64_t Engine::go(const Position &pos, const SearchLimits &limits) {
+    std::uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = ++m_nextId;
+        m_pending.emplace(Job{pos, limits, id});
+        m_stop = true; // Abort the running search; the main thread then picks up this job
+    }
+    m_cv.notify_all();
+    Trace::instant("go", "id", std::int64_t(id));
+    return id;
+}
+
+void Engine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending) m_pending->stopped = true;
+        m_stop = true;
+    }
+    m_cv.notify_all();
+}
+
+void Engine::ponderhit() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // The ponder search hasn't started yet: start it as a normal search
+        if (m_pending) {
+            m_pending->limits.ponder = false;
+            return;
+        }
+        if (!m_pondering) return;
+        m_clockStart = std::chrono::steady_clock::now();
+        m_pondering = false;
+    }
+    m_cv.notify_all();
+}
+
+void Engine::waitForIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_searching && !m_pending; });
+}
+
+int Engine::elapsedMs() const {
+    return int(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime).count());
+}
+
+int Engine::clockMs() const {
+    return int(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_clockStart.load()).count());
+}
+
+std::uint64_t Engine::totalNodes() const {
+    std::uint64_t total = 0;
+    for (const auto &worker : m_workers) total += worker->nodes.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Engine::reportIteration(const SearchWorker &worker) {
+    if (!m_onInfo) return;
+
+    SearchInfo info;
+    info.searchId = m_current.id;
+    info.depth = worker.completedDepth;
+    info.selDepth = worker.selDepth;
+    info.nodes = totalNodes();
+    info.timeMs = elapsedMs();
+    info.nps = info.nodes * 1000 / std::max(info.timeMs, 1);
+    info.hashfull = m_tt.hashfull();
+    for (int i = 0; i < worker.lineCount; ++i) {
+        const RootLine &line = worker.lines[i];
+        info.lines.push_back({line.score, std::vector<Move>(line.pv, line.pv + line.pvLength)});
+    }
+    m_onInfo(info);
+}
+
+void Engine::mainLoop() {
+    Trace::setThreadName("search main");
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_quit || m_pending; });
+            if (m_quit) return;
+
+            m_current = std::move(*m_pending);
+            m_pending.reset();
+            m_searching = true;
+            m_stop = m_current.stopped;
+            m_pondering = m_current.limits.ponder && !m_current.stopped;
+            m_startTime = std::chrono::steady_clock::now();
+            m_clockStart = m_startTime;
+            m_tt.newSearch();
+            m_activeHelpers = int(m_helperThreads.size());
+            ++m_generation;
+        }
+        m_cv.notify_all();
+
+        SearchWorker &main = *m_workers[0];
+        Trace::Scope search("search", "id", std::int64_t(m_current.id));
+        main.run(m_current.position, m_current.limits);
+
+        // A search that ran out of depth while pondering or analysing must not answer early
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || (!m_pondering && !m_current.limits.infinite); });
+        }
+
+        // Helpers only stop on the flag, so raise it once the main thread is done
+        m_stop = true;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_activeHelpers == 0; });
+        }
+
+        if (m_onBestMove) {
+            SearchResult result;
+            result.searchId = m_current.id;
+            result.bestMove = main.bestMove;
+            result.ponderMove = main.lineCount && main.lines[0].pvLength > 1 ? main.lines[0].pv[1] : Move::none();
+            result.score = main.lineCount ? main.lines[0].score : 0;
+            result.depth = main.completedDepth;
+            result.gameResult = main.rootResult;
+            m_onBestMove(result);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_searching = false;
+        }
+        m_cv.notify_all();
+    }
+}
+
+void Engine::helperLoop(int index) {
+    Trace::setThreadName("search helper " + std::to_string(index));
+    std::uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [&] { return m_quit || m_generation != seenGeneration; });
+            if (m_quit) {
+                // The main thread counted this helper in and waits for it to check out
+                if (m_generation != seenGeneration) {
+                    --m_activeHelpers;
+                    lock.unlock();
+                    m_cv.notify_all();
+                }
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        m_workers[index]->run(m_current.position, m_current.limits);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeHelpers;
+        }
+        m_cv.notify_all();
+    }
+}
@@ -0,0 +1,220 @@
+#ifndef CHESS_SEARCH_H
+#define CHESS_SEARCH_H
+
+#include "TranspositionTable.h"
+#include "MoveGen.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+constexpr int MaxPly = 128;
+constexpr int MateScore = 32000;
+constexpr int InfiniteScore = 32001;
+
+// Scores beyond this bound are mates; the distance is MateScore - |score| plies
+constexpr int MateInMaxPly = MateScore - MaxPly;
+
+struct SearchLimits {
+    int depth = 0;      // 0 means no depth limit
+    int moveTimeMs = 0; // 0 means no time limit
+    bool infinite = false;
+    bool ponder = false; // Searching the predicted reply on the opponent's time
+    int multiPV = 1;     // Number of best root moves to find, each with its own line
+};
+
+// Selectivity switches and margins. The defaults are the tuned values; margins are in
+// centipawns and reductions in plies unless noted. Set them while the engine is idle.
+struct SearchParams {
+    bool nullMove = true;
+    int nullMoveMinDepth = 3;
+    int nullMoveReduction = 3;      // R = reduction + depth / depthDivisor + a bonus for eval above beta
+    int nullMoveDepthDivisor = 4;
+    int nullMoveVerifyDepth = 10;   // From this depth a null-move cutoff is verified by a reduced search
+
+    bool lateMoveReductions = true;
+    int lmrBase = 75;               // Reduction = base / 100 + ln(depth) * ln(moveNumber) * 100 / divisor
+    int lmrDivisor = 225;
+
+    bool futility = true;
+    int futilityDepth = 6;
+    int futilityMargin = 120;       // Per ply of remaining depth
+
+    bool reverseFutility = true;
+    int reverseFutilityDepth = 6;
+    int reverseFutilityMargin = 90; // Per ply of remaining depth
+
+    bool razoring = true;
+    int razoringDepth = 2;
+    int razoringMargin = 250;       // Per ply of remaining depth
+
+    bool lateMovePruning = true;
+    int lmpDepth = 8;
+    int lmpBase = 3;                // Quiet moves tried before pruning: base + depth * depth
+
+    bool singularExtensions = true;
+    int singularDepth = 8;
+    int singularMargin = 2;         // Per ply of remaining depth
+};
+
+// Named views of the parameters, so UCI options and bench can list them generically
+struct SearchToggle {
+    const char *name;
+    bool SearchParams::*flag;
+};
+
+struct SearchTunable {
+    const char *name;
+    int SearchParams::*value;
+    int min, max;
+};
+
+inline constexpr SearchToggle SearchToggles[] = {
+    {"NullMove", &SearchParams::nullMove},
+    {"LateMoveReductions", &SearchParams::lateMoveReductions},
+    {"Futility", &SearchParams::futility},
+    {"ReverseFutility", &SearchParams::reverseFutility},
+    {"Razoring", &SearchParams::razoring},
+    {"LateMovePruning", &SearchParams::lateMovePruning},
+    {"SingularExtensions", &SearchParams::singularExtensions},
+};
+
+inline constexpr SearchTunable SearchTunables[] = {
+    {"NullMoveMinDepth", &SearchParams::nullMoveMinDepth, 1, 10},
+    {"NullMoveReduction", &SearchParams::nullMoveReduction, 1, 6},
+    {"NullMoveDepthDivisor", &SearchParams::nullMoveDepthDivisor, 1, 16},
+    {"NullMoveVerifyDepth", &SearchParams::nullMoveVerifyDepth, 1, MaxPly},
+    {"LmrBase", &SearchParams::lmrBase, 0, 300},
+    {"LmrDivisor", &SearchParams::lmrDivisor, 50, 1000},
+    {"FutilityDepth", &SearchParams::futilityDepth, 1, 16},
+    {"FutilityMargin", &SearchParams::futilityMargin, 0, 1000},
+    {"ReverseFutilityDepth", &SearchParams::reverseFutilityDepth, 1, 16},
+    {"ReverseFutilityMargin", &SearchParams::reverseFutilityMargin, 0, 1000},
+    {"RazoringDepth", &SearchParams::razoringDepth, 1, 8},
+    {"RazoringMargin", &SearchParams::razoringMargin, 0, 2000},
+    {"LmpDepth", &SearchParams::lmpDepth, 1, 16},
+    {"LmpBase", &SearchParams::lmpBase, 0, 64},
+    {"SingularDepth", &SearchParams::singularDepth, 2, 32},
+    {"SingularMargin", &SearchParams::singularMargin, 0, 16},
+};
+
+struct PvLine {
+    int score = 0; // From the side to move's point of view
+    std::vector<Move> pv;
+};
+
+// One completed iteration, reported from the main search thread
+struct SearchInfo {
+    std::uint64_t searchId = 0;
+    int depth = 0;
+    int selDepth = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t nps = 0;
+    int timeMs = 0;
+    int hashfull = 0;
+    std::vector<PvLine> lines; // Best first; more than one with MultiPV
+};
+
+struct SearchResult {
+    std::uint64_t searchId = 0;
+    Move bestMove = Move::none();
+    Move ponderMove = Move::none();
+    int score = 0;
+    int depth = 0;
+    // Anything but Ongoing means the searched position was already decided; a mated or
+    // stalemated side has no bestMove
+    GameResult gameResult = GameResult::Ongoing;
+};
+
+class SearchWorker;
+
+// Lazy SMP searcher. The threads are created once and wait for work, so go() and stop()
+// never block the caller. Callbacks run on the main search thread; a GUI must forward
+// them to its own thread and can use searchId to drop results of superseded searches.
+// Infinite and ponder searches hold their best move back until stop() or ponderhit().
+class Engine {
+public:
+    using InfoCallback = std::function<void(const SearchInfo &)>;
+    using BestMoveCallback = std::function<void(const SearchResult &)>;
+
+    explicit Engine(int threads = 1, int hashMegabytes = 64);
+    ~Engine();
+
+    Engine(const Engine &) = delete;
+    Engine &operator=(const Engine &) = delete;
+
+    // Set these while idle
+    void setInfoCallback(InfoCallback callback) { m_onInfo = std::move(callback); }
+    void setBestMoveCallback(BestMoveCallback callback) { m_onBestMove = std::move(callback); }
+    void setThreads(int threads);
+    void setHashSize(int megabytes);
+    void clearHash();
+    void setParams(const SearchParams &params);
+    const SearchParams &params() const { return m_params; }
+
+    // Starts searching a copy of pos, aborting whatever was running; returns the search id
+    std::uint64_t go(const Position &pos, const SearchLimits &limits);
+    void stop();
+    // The predicted move was played: keep the running search and start its clock now
+    void ponderhit();
+    void waitForIdle();
+
+    int threadCount() const { return int(m_workers.size()); }
+
+private:
+    friend class SearchWorker;
+
+    struct Job {
+        Position position;
+        SearchLimits limits;
+        std::uint64_t id = 0;
+        // Stopped before it started; it still runs, aborted at once, so it answers with a move
+        bool stopped = false;
+    };
+
+    void startThreads(int threads);
+    void stopThreads();
+    void mainLoop();
+    void helperLoop(int index);
+
+    int elapsedMs() const;
+    int clockMs() const;
+    std::uint64_t totalNodes() const;
+    void reportIteration(const SearchWorker &worker);
+
+    TranspositionTable m_tt;
+    SearchParams m_params;
+    // Late-move reductions by [depth][move number], rebuilt from m_params
+    int m_reductions[64][64];
+    std::vector<std::unique_ptr<SearchWorker>> m_workers;
+    std::thread m_mainThread;
+    std::vector<std::thread> m_helperThreads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::optional<Job> m_pending;
+    Job m_current;
+    std::uint64_t m_nextId = 0;
+    std::uint64_t m_generation = 0;
+    int m_activeHelpers = 0;
+    bool m_searching = false;
+    bool m_quit = false;
+
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_pondering{false};
+    std::chrono::steady_clock::time_point m_startTime;
+    // Time limits count from here; for a ponder search that is the ponderhit
+    std::atomic<std::chrono::steady_clock::time_point> m_clockStart;
+
+    InfoCallback m_onInfo;
+    BestMoveCallback m_onBestMove;
+};
+
+#endif //CHESS_SEARCH_H
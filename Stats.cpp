@@ -0,0 +1,66 @@
+#include "Stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // Blocks are handed out once per thread and never reused. Threads beyond the last
+    // block share the overflow one, where concurrent increments may be lost.
+    constexpr int MaxThreads = 512;
+    Stats::ThreadCounters blocks[MaxThreads];
+    Stats::ThreadCounters overflow;
+    std::atomic<int> blocksUsed{0};
+
+    // Reset subtracts the totals seen at the time instead of zeroing blocks other threads write
+    Stats::ThreadCounters baseline;
+
+    Stats::Snapshot rawTotals() {
+        Stats::Snapshot total;
+        auto addBlock = [&total](const Stats::ThreadCounters &block) {
+            for (int i = 0; i < Stats::CounterCount; ++i) total.counters[i] += block.counters[i].load(std::memory_order_relaxed);
+            for (int i = 0; i < Stats::CutoffSlots; ++i) total.cutoffs[i] += block.cutoffs[i].load(std::memory_order_relaxed);
+        };
+        int used = std::min(blocksUsed.load(std::memory_order_acquire), MaxThreads);
+        for (int i = 0; i < used; ++i) addBlock(blocks[i]);
+        addBlock(overflow);
+        return total;
+    }
+}
+
+Stats::ThreadCounters *Stats::registerThread() {
+    int index = blocksUsed.fetch_add(1, std::memory_order_acq_rel);
+    return index < MaxThreads ? &blocks[index] : &overflow;
+}
+
+Stats::Snapshot Stats::snapshot() {
+    Snapshot total = rawTotals();
+    for (int i = 0; i < CounterCount; ++i) total.counters[i] -= baseline.counters[i].load(std::memory_order_relaxed);
+    for (int i = 0; i < CutoffSlots; ++i) total.cutoffs[i] -= baseline.cutoffs[i].load(std::memory_order_relaxed);
+    return total;
+}
+
+void Stats::reset() {
+    Snapshot total = rawTotals();
+    for (int i = 0; i < CounterCount; ++i) baseline.counters[i].store(total.counters[i], std::memory_order_relaxed);
+    for (int i = 0; i < CutoffSlots; ++i) baseline.cutoffs[i].store(total.cutoffs[i], std::memory_order_relaxed);
+}
+
+const char *Stats::name(Counter counter) {
+    static const char *const Names[CounterCount] = {"nodes", "qnodes", "tthits", "ttmisses", "ttcollisions", "evals", "movegens"};
+    return Names[counter];
+}
+
+std::string Stats::format(const Snapshot &snapshot) {
+    std::ostringstream out;
+    for (int i = 0; i < CounterCount; ++i) out << (i ? " " : "") << name(Counter(i)) << ' ' << snapshot.counters[i];
+
+    std::uint64_t cutoffs = 0;
+    for (std::uint64_t count : snapshot.cutoffs) cutoffs += count;
+    out << " cutoffs " << cutoffs;
+    if (cutoffs) {
+        out << " bymove" << std::fixed << std::setprecision(1);
+        for (std::uint64_t count : snapshot.cutoffs) out << ' ' << 100.0 * count / cutoffs << '%';
+    }
+    return out.str();
+}
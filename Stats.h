@@ -0,0 +1,67 @@
+#ifndef CHESS_STATS_H
+#define CHESS_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Hot-path counters for profiling. Each thread counts into its own block, written only
+// by that thread, and readers sum the blocks while the threads keep running. The
+// counters only exist in builds configured with CHESS_STATS; elsewhere the CHESS_STAT
+// macros expand to nothing.
+namespace Stats {
+    enum Counter { Nodes, QNodes, TTHits, TTMisses, TTCollisions, EvalCalls, MoveGenCalls, CounterCount };
+
+    // Beta cutoffs by the index of the move that cut; the last slot takes every later move
+    constexpr int CutoffSlots = 8;
+
+#ifdef CHESS_STATS
+    constexpr bool Enabled = true;
+#else
+    constexpr bool Enabled = false;
+#endif
+
+    struct Snapshot {
+        std::uint64_t counters[CounterCount] = {};
+        std::uint64_t cutoffs[CutoffSlots] = {};
+    };
+
+    // Cache-line aligned, so threads counting side by side don't share lines
+    struct alignas(64) ThreadCounters {
+        std::atomic<std::uint64_t> counters[CounterCount] = {};
+        std::atomic<std::uint64_t> cutoffs[CutoffSlots] = {};
+    };
+
+    ThreadCounters *registerThread();
+
+    inline ThreadCounters &localCounters() {
+        thread_local ThreadCounters *counters = registerThread();
+        return *counters;
+    }
+
+    // A plain load and store: the owning thread is the only writer
+    inline void bump(std::atomic<std::uint64_t> &counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    inline void add(Counter counter) { bump(localCounters().counters[counter]); }
+    inline void addCutoff(int moveIndex) { bump(localCounters().cutoffs[moveIndex < CutoffSlots ? moveIndex : CutoffSlots - 1]); }
+
+    // Totals over all threads since the last reset
+    Snapshot snapshot();
+    void reset();
+
+    const char *name(Counter counter);
+    // One line of "name value" pairs, then the share of cutoffs by move index
+    std::string format(const Snapshot &snapshot);
+}
+
+#ifdef CHESS_STATS
+#define CHESS_STAT(counter) Stats::add(Stats::counter)
+#define CHESS_STAT_CUTOFF(moveIndex) Stats::addCutoff(moveIndex)
+#else
+#define CHESS_STAT(counter) ((void)0)
+#define CHESS_STAT_CUTOFF(moveIndex) ((void)0)
+#endif
+
+#endif //CHESS_STATS_H
@@ -0,0 +1,62 @@
+#include "StatsPanel.h"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QStringList>
+#include <QTimer>
+#include <QVBoxLayout>
+
+StatsPanel::StatsPanel(QWidget *parent) : QWidget(parent) {
+    QLabel *title = new QLabel("Engine counters", this);
+    QPushButton *resetButton = new QPushButton("Reset", this);
+    m_countersLabel = new QLabel(this);
+    m_cutoffsLabel = new QLabel(this);
+    m_cutoffsLabel->setWordWrap(true);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QHBoxLayout *titleLayout = new QHBoxLayout;
+    titleLayout->addWidget(title, 1);
+    titleLayout->addWidget(resetButton);
+    layout->addLayout(titleLayout);
+    layout->addWidget(m_countersLabel);
+    layout->addWidget(m_cutoffsLabel);
+    setFixedWidth(220);
+
+    connect(resetButton, &QPushButton::clicked, this, [this] {
+        Stats::reset();
+        refresh();
+    });
+
+    m_timer = new QTimer(this);
+    connect(m_timer, &QTimer::timeout, this, &StatsPanel::refresh);
+    m_timer->start(500);
+    refresh();
+}
+
+void StatsPanel::refresh() {
+    if (!Stats::Enabled) {
+        m_countersLabel->setText("Built without CHESS_STATS");
+        m_cutoffsLabel->clear();
+        return;
+    }
+
+    Stats::Snapshot snapshot = Stats::snapshot();
+    QStringList lines;
+    for (int i = 0; i < Stats::CounterCount; ++i) {
+        lines << QString("%1: %2").arg(Stats::name(Stats::Counter(i))).arg(snapshot.counters[i]);
+    }
+    std::uint64_t probes = snapshot.counters[Stats::TTHits] + snapshot.counters[Stats::TTMisses] + snapshot.counters[Stats::TTCollisions];
+    if (probes) lines << QString("tt hit rate: %1%").arg(100.0 * snapshot.counters[Stats::TTHits] / probes, 0, 'f', 1);
+    m_countersLabel->setText(lines.join('\n'));
+
+    // Good move ordering shows as most cutoffs on the first move
+    std::uint64_t cutoffs = 0;
+    for (std::uint64_t count : snapshot.cutoffs) cutoffs += count;
+    QStringList shares;
+    for (int i = 0; i < Stats::CutoffSlots; ++i) {
+        QString index = i == Stats::CutoffSlots - 1 ? QString("%1+").arg(i + 1) : QString::number(i + 1);
+        shares << QString("%1: %2%").arg(index).arg(cutoffs ? 100.0 * snapshot.cutoffs[i] / cutoffs : 0.0, 0, 'f', 1);
+    }
+    m_cutoffsLabel->setText("cutoffs by move\n" + shares.join("  "));
+}
@@ -0,0 +1,27 @@
+#ifndef CHESS_STATSPANEL_H
+#define CHESS_STATSPANEL_H
+
+#include <QWidget>
+
+#include "Stats.h"
+
+class QLabel;
+class QTimer;
+
+// Shows the engine's hot-path counters, refreshed twice a second. The counters cover
+// every engine in the process: the game's and the analysis's.
+class StatsPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit StatsPanel(QWidget *parent = nullptr);
+
+private:
+    void refresh();
+
+    QLabel *m_countersLabel;
+    QLabel *m_cutoffsLabel;
+    QTimer *m_timer;
+};
+
+#endif //CHESS_STATSPANEL_H
@@ -0,0 +1,177 @@
+#include "Trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::enabledFlag{false};
+
+namespace {
+    constexpr std::size_t BufferEvents = 8192;
+    // Buffers outlive their threads so a dump still shows threads that have exited
+    constexpr std::size_t MaxBuffers = 256;
+
+    struct Event {
+        const char *name;
+        const char *argName;
+        std::int64_t arg;
+        std::int64_t start;
+        std::int64_t duration; // -1 for an instant event
+    };
+
+    // One ring entry. The owning thread writes it while a dump may be reading it, so every
+    // field is atomic and sequence says which event the fields hold: 0 while it is being
+    // rewritten, else the event's index + 1. A reader keeps a copy only if it saw the same
+    // sequence before and after copying.
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<const char*> argName{nullptr};
+        std::atomic<std::int64_t> arg{0};
+        std::atomic<std::int64_t> start{0};
+        std::atomic<std::int64_t> duration{0};
+    };
+
+    struct Buffer {
+        int tid;
+        std::string threadName;
+        Slot slots[BufferEvents];
+        // Events ever written; the newest BufferEvents of them are kept
+        std::atomic<std::uint64_t> written{0};
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    const auto epoch = std::chrono::steady_clock::now();
+
+    thread_local std::string localThreadName;
+    thread_local Buffer *localBufferPointer = nullptr;
+    thread_local bool localBufferTried = false;
+
+    // Created on the thread's first event, so threads that never trace cost nothing
+    Buffer *localBuffer() {
+        if (!localBufferTried) {
+            localBufferTried = true;
+            std::lock_guard<std::mutex> lock(registryMutex);
+            if (buffers.size() < MaxBuffers) {
+                buffers.push_back(std::make_unique<Buffer>());
+                buffers.back()->tid = int(buffers.size());
+                buffers.back()->threadName = localThreadName;
+                localBufferPointer = buffers.back().get();
+            }
+        }
+        return localBufferPointer;
+    }
+
+    void push(const Event &event) {
+        Buffer *buffer = localBuffer();
+        if (!buffer) return;
+        std::uint64_t index = buffer->written.load(std::memory_order_relaxed);
+        Slot &slot = buffer->slots[index % BufferEvents];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.argName.store(event.argName, std::memory_order_relaxed);
+        slot.arg.store(event.arg, std::memory_order_relaxed);
+        slot.start.store(event.start, std::memory_order_relaxed);
+        slot.duration.store(event.duration, std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+        buffer->written.store(index + 1, std::memory_order_release);
+    }
+
+    // False if the slot no longer, or not yet, holds event index
+    bool read(const Slot &slot, std::uint64_t index, Event &event) {
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) return false;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.argName = slot.argName.load(std::memory_order_relaxed);
+        event.arg = slot.arg.load(std::memory_order_relaxed);
+        event.start = slot.start.load(std::memory_order_relaxed);
+        event.duration = slot.duration.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+    }
+
+    // Names are literals from our own code, but keep the JSON valid whatever they hold
+    void writeString(std::ofstream &out, const std::string &text) {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out << c;
+        }
+        out << '"';
+    }
+}
+
+void Trace::setEnabled(bool enabled) {
+    enabledFlag.store(enabled, std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(const std::string &name) {
+    localThreadName = name;
+    if (localBufferPointer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        localBufferPointer->threadName = name;
+    }
+}
+
+std::int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Trace::record(const char *name, std::int64_t startNs, std::int64_t durationNs, const char *argName, std::int64_t arg) {
+    push({name, argName, arg, startNs, durationNs});
+}
+
+void Trace::instant(const char *name, const char *argName, std::int64_t arg) {
+    if (enabled()) push({name, argName, arg, now(), -1});
+}
+
+bool Trace::writeChromeJson(const std::string &path) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first] {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    for (const auto &buffer : buffers) {
+        if (!buffer->threadName.empty()) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+            writeString(out, buffer->threadName);
+            out << "}}";
+        }
+
+        std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+        std::uint64_t begin = written > BufferEvents ? written - BufferEvents : 0;
+        for (std::uint64_t i = begin; i < written; ++i) {
+            // Overwritten by the owning thread since written was read
+            Event event;
+            if (!read(buffer->slots[i % BufferEvents], i, event)) continue;
+            separator();
+            // Chrome traces count in microseconds
+            out << "{\"name\":";
+            writeString(out, event.name);
+            out << ",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << event.start / 1000.0;
+            if (event.duration < 0) {
+                out << ",\"ph\":\"i\",\"s\":\"t\"";
+            } else {
+                out << ",\"ph\":\"X\",\"dur\":" << event.duration / 1000.0;
+            }
+            if (event.argName) {
+                out << ",\"args\":{";
+                writeString(out, event.argName);
+                out << ':' << event.arg << '}';
+            }
+            out << '}';
+        }
+    }
+    out << "]}\n";
+    return bool(out);
+}
@@ -0,0 +1,53 @@
+#ifndef CHESS_TRACE_H
+#define CHESS_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Timeline tracing for "what was each thread doing" questions, such as a frozen board.
+// Each thread records into its own ring buffer, keeping its most recent events, and
+// writeChromeJson() dumps them all in the Chrome trace format (chrome://tracing,
+// ui.perfetto.dev). Off by default; while off, recording is one relaxed load.
+// Event and argument names must be string literals: only the pointers are stored.
+namespace Trace {
+    extern std::atomic<bool> enabledFlag;
+
+    inline bool enabled() { return enabledFlag.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+
+    // Labels the calling thread in the dump
+    void setThreadName(const std::string &name);
+
+    // Nanoseconds on the trace clock
+    std::int64_t now();
+
+    void record(const char *name, std::int64_t startNs, std::int64_t durationNs, const char *argName = nullptr, std::int64_t arg = 0);
+    // An event without duration, such as a search being started
+    void instant(const char *name, const char *argName = nullptr, std::int64_t arg = 0);
+
+    // Events still in the buffers. Safe while other threads keep tracing; events they
+    // overwrite during the dump are left out.
+    bool writeChromeJson(const std::string &path);
+
+    // Records the time from construction to destruction as one event
+    class Scope {
+    public:
+        explicit Scope(const char *name, const char *argName = nullptr, std::int64_t arg = 0)
+                : m_name(enabled() ? name : nullptr), m_argName(argName), m_arg(arg), m_start(m_name ? now() : 0) {}
+        ~Scope() {
+            if (m_name) record(m_name, m_start, now() - m_start, m_argName, m_arg);
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *m_name;
+        const char *m_argName;
+        std::int64_t m_arg;
+        std::int64_t m_start;
+    };
+}
+
+#endif //CHESS_TRACE_H
@@ -0,0 +1,79 @@
+#include "TranspositionTable.h"
+#include "Stats.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+    // Layout of a packed entry, from the lowest bits up:
+    //   16 bits key check, 16 bits move, 16 bits score, 8 bits depth, 6 bits generation, 2 bits bound
+    std::uint64_t pack(Key key, Move move, int score, int depth, std::uint8_t generation, Bound bound) {
+        return (key >> 48)
+             | std::uint64_t(move.raw()) << 16
+             | std::uint64_t(std::uint16_t(score)) << 32
+             | std::uint64_t(std::uint8_t(depth)) << 48
+             | std::uint64_t((generation << 2) | int(bound)) << 56;
+    }
+
+    std::uint16_t keyCheck(std::uint64_t data) { return std::uint16_t(data); }
+    int depthOf(std::uint64_t data) { return std::uint8_t(data >> 48); }
+    std::uint8_t generationOf(std::uint64_t data) { return std::uint8_t(data >> 58); }
+    Bound boundOf(std::uint64_t data) { return Bound((data >> 56) & 3); }
+}
+
+void TranspositionTable::resize(std::size_t megabytes) {
+    // Round down to a power of two so indexing is a mask
+    std::size_t entries = std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(std::uint64_t), 1024);
+    m_size = std::bit_floor(entries);
+    m_table = std::make_unique<std::atomic<std::uint64_t>[]>(m_size);
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < m_size; ++i) m_table[i].store(0, std::memory_order_relaxed);
+    m_generation = 0;
+}
+
+bool TranspositionTable::probe(Key key, TTEntry &entry) const {
+    std::uint64_t data = slot(key).load(std::memory_order_relaxed);
+    if (boundOf(data) == Bound::None) {
+        CHESS_STAT(TTMisses);
+        return false;
+    }
+    // The slot holds another position
+    if (keyCheck(data) != std::uint16_t(key >> 48)) {
+        CHESS_STAT(TTCollisions);
+        return false;
+    }
+    CHESS_STAT(TTHits);
+
+    entry.move = Move::fromRaw(std::uint16_t(data >> 16));
+    entry.score = std::int16_t(data >> 32);
+    entry.depth = depthOf(data);
+    entry.bound = boundOf(data);
+    return true;
+}
+
+void TranspositionTable::store(Key key, Move move, int score, int depth, Bound bound) {
+    std::atomic<std::uint64_t> &target = slot(key);
+    std::uint64_t old = target.load(std::memory_order_relaxed);
+
+    // Keep a deeper entry from the current search unless this is the same position
+    bool samePosition = keyCheck(old) == std::uint16_t(key >> 48);
+    if (!samePosition && generationOf(old) == m_generation && depthOf(old) > depth + 2) return;
+
+    // Don't lose the best move of a position when re-storing it without one
+    if (move.isNone() && samePosition) move = Move::fromRaw(std::uint16_t(old >> 16));
+
+    target.store(pack(key, move, score, std::max(depth, 0), m_generation, bound), std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    std::size_t sample = std::min<std::size_t>(m_size, 1000);
+    int used = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+        std::uint64_t data = m_table[i].load(std::memory_order_relaxed);
+        if (boundOf(data) != Bound::None && generationOf(data) == m_generation) ++used;
+    }
+    return int(used * 1000 / sample);
+}
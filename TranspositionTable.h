@@ -0,0 +1,45 @@
+#ifndef CHESS_TRANSPOSITIONTABLE_H
+#define CHESS_TRANSPOSITIONTABLE_H
+
+#include "Move.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum class Bound : std::uint8_t { None, Upper, Lower, Exact };
+
+struct TTEntry {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Shared by all search threads without locks. Each entry is packed into one 64-bit word
+// (key check, move, score, depth, generation and bound), so a racing write can replace
+// an entry but never tear it.
+class TranspositionTable {
+public:
+    void resize(std::size_t megabytes);
+    void clear();
+
+    // Ages existing entries so the next search prefers to overwrite them
+    void newSearch() { m_generation = (m_generation + 1) & 0x3f; }
+
+    bool probe(Key key, TTEntry &entry) const;
+    void store(Key key, Move move, int score, int depth, Bound bound);
+
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+
+private:
+    std::atomic<std::uint64_t> &slot(Key key) const { return m_table[key & (m_size - 1)]; }
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_table;
+    std::size_t m_size = 0;
+    std::uint8_t m_generation = 0;
+};
+
+#endif //CHESS_TRANSPOSITIONTABLE_H
@@ -0,0 +1,45 @@
+#ifndef CHESS_TYPES_H
+#define CHESS_TYPES_H
+
+#include <cstdint>
+
+using Bitboard = std::uint64_t;
+using Key = std::uint64_t;
+
+// Squares are numbered row * 8 + col in board coordinates, so a1 = 0 and h8 = 63.
+// Row 0 is White's back rank, the same layout ChessBoard uses for its items.
+using Square = int;
+constexpr Square NoSquare = 64;
+
+enum Color : int { White, Black };
+
+constexpr Color operator~(Color c) { return Color(c ^ 1); }
+
+constexpr int pawnPush(Color c) { return c == White ? 8 : -8; }
+
+// Castling rights as a 4-bit mask
+enum CastlingRights : int {
+    NoCastling = 0,
+    WhiteKingSide = 1,
+    WhiteQueenSide = 2,
+    BlackKingSide = 4,
+    BlackQueenSide = 8,
+    AllCastling = 15
+};
+
+enum class PieceType { Pawn, Rook, Knight, Bishop, Queen, King };
+
+constexpr int PieceTypeCount = 6;
+
+// A colored piece as stored in the position's mailbox; NoPiece marks an empty square
+enum Piece : std::int8_t { NoPiece = -1 };
+
+constexpr Piece makePiece(Color c, PieceType pt) { return Piece(int(c) * PieceTypeCount + int(pt)); }
+constexpr Color colorOf(Piece p) { return Color(p / PieceTypeCount); }
+constexpr PieceType typeOf(Piece p) { return PieceType(p % PieceTypeCount); }
+
+constexpr int rowOf(Square s) { return s >> 3; }
+constexpr int colOf(Square s) { return s & 7; }
+constexpr Square makeSquare(int row, int col) { return row * 8 + col; }
+
+#endif //CHESS_TYPES_H
@@ -0,0 +1,205 @@
+#include "Uci.h"
+#include "Search.h"
+#include "Stats.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+    const char *const StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // Engine callbacks print from the search thread while the input loop prints replies
+    std::mutex outputMutex;
+
+    void send(const std::string &line) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << line << std::endl;
+    }
+
+    std::string formatScore(int score) {
+        if (std::abs(score) >= MateInMaxPly) {
+            int movesToMate = (MateScore - std::abs(score) + 1) / 2;
+            return "mate " + std::to_string(score > 0 ? movesToMate : -movesToMate);
+        }
+        return "cp " + std::to_string(score);
+    }
+
+    const char *gameResultName(GameResult result) {
+        switch (result) {
+            case GameResult::Checkmate: return "checkmate";
+            case GameResult::Stalemate: return "stalemate";
+            case GameResult::FiftyMoves: return "fifty-move rule";
+            case GameResult::Repetition: return "threefold repetition";
+            case GameResult::InsufficientMaterial: return "insufficient material";
+            case GameResult::Ongoing: break;
+        }
+        return "ongoing";
+    }
+
+    // "position [startpos | fen <fen>] [moves <move>...]"
+    void setPosition(Position &pos, std::istringstream &args) {
+        std::string token, fen;
+        args >> token;
+        if (token == "startpos") {
+            fen = StartFen;
+            args >> token;
+        } else if (token == "fen") {
+            while (args >> token && token != "moves") fen += token + " ";
+        } else {
+            return;
+        }
+
+        if (!pos.setFen(fen)) {
+            send("info string invalid fen");
+            pos.setFen(StartFen);
+            return;
+        }
+        while (args >> token) {
+            Move move = parseUciMove(pos, token);
+            if (move.isNone()) {
+                send("info string illegal move " + token);
+                return;
+            }
+            pos.doMove(move);
+        }
+    }
+
+    // Spends a fixed share of the remaining clock plus most of the increment
+    int allocateTime(int remaining, int increment, int movesToGo) {
+        int share = remaining / (movesToGo > 0 ? movesToGo : 30) + increment * 3 / 4;
+        return std::max(1, std::min(share, remaining - 50));
+    }
+
+    SearchLimits parseGo(const Position &pos, std::istringstream &args) {
+        SearchLimits limits;
+        int time[2] = {0, 0}, increment[2] = {0, 0}, movesToGo = 0;
+        std::string token;
+        while (args >> token) {
+            if (token == "depth") args >> limits.depth;
+            else if (token == "movetime") args >> limits.moveTimeMs;
+            else if (token == "infinite") limits.infinite = true;
+            else if (token == "ponder") limits.ponder = true;
+            else if (token == "wtime") args >> time[White];
+            else if (token == "btime") args >> time[Black];
+            else if (token == "winc") args >> increment[White];
+            else if (token == "binc") args >> increment[Black];
+            else if (token == "movestogo") args >> movesToGo;
+        }
+
+        Color us = pos.sideToMove();
+        if (!limits.moveTimeMs && time[us] > 0) limits.moveTimeMs = allocateTime(time[us], increment[us], movesToGo);
+        return limits;
+    }
+
+    // "setoption name <name> value <value>"
+    void setOption(Engine &engine, int &multiPV, std::istringstream &args) {
+        std::string token, name, value;
+        args >> token;
+        while (args >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+        args >> value;
+
+        for (const SearchToggle &toggle : SearchToggles) {
+            if (name != toggle.name) continue;
+            SearchParams params = engine.params();
+            params.*toggle.flag = value == "true";
+            engine.setParams(params);
+        }
+        for (const SearchTunable &tunable : SearchTunables) {
+            if (name != tunable.name) continue;
+            SearchParams params = engine.params();
+            params.*tunable.value = std::clamp(std::atoi(value.c_str()), tunable.min, tunable.max);
+            engine.setParams(params);
+        }
+
+        if (name == "Hash") engine.setHashSize(std::atoi(value.c_str()));
+        else if (name == "Threads") engine.setThreads(std::atoi(value.c_str()));
+        else if (name == "MultiPV") multiPV = std::clamp(std::atoi(value.c_str()), 1, MaxMoves);
+        // Ponder only tells us the GUI may send "go ponder"; nothing to configure
+    }
+}
+
+Move parseUciMove(const Position &pos, const std::string &text) {
+    MoveList list;
+    generateLegalMoves(pos, list);
+    for (Move move : list) {
+        if (moveToUci(move) == text) return move;
+    }
+    return Move::none();
+}
+
+int runUci() {
+    Engine engine(1, 64);
+    Position pos;
+
+    int multiPV = 1;
+
+    engine.setInfoCallback([](const SearchInfo &info) {
+        for (std::size_t i = 0; i < info.lines.size(); ++i) {
+            std::ostringstream line;
+            line << "info depth " << info.depth << " seldepth " << info.selDepth << " multipv " << i + 1
+                 << " score " << formatScore(info.lines[i].score) << " nodes " << info.nodes << " nps " << info.nps
+                 << " hashfull " << info.hashfull << " time " << info.timeMs << " pv";
+            for (Move move : info.lines[i].pv) line << ' ' << moveToUci(move);
+            send(line.str());
+        }
+    });
+    engine.setBestMoveCallback([](const SearchResult &result) {
+        if (result.gameResult != GameResult::Ongoing) send(std::string("info string game over: ") + gameResultName(result.gameResult));
+        std::string line = "bestmove " + (result.bestMove.isNone() ? std::string("0000") : moveToUci(result.bestMove));
+        if (!result.ponderMove.isNone()) line += " ponder " + moveToUci(result.ponderMove);
+        if (Stats::Enabled) send("info string stats " + Stats::format(Stats::snapshot()));
+        send(line);
+    });
+
+    std::string input;
+    while (std::getline(std::cin, input)) {
+        std::istringstream args(input);
+        std::string command;
+        args >> command;
+
+        if (command == "uci") {
+            send("id name Chess");
+            send("option name Hash type spin default 64 min 1 max 4096");
+            send("option name Threads type spin default 1 min 1 max " + std::to_string(std::max(1u, std::thread::hardware_concurrency())));
+            send("option name Ponder type check default false");
+            send("option name MultiPV type spin default 1 min 1 max " + std::to_string(MaxMoves));
+            // Selectivity switches and margins, exposed for tuning
+            SearchParams defaults;
+            for (const SearchToggle &toggle : SearchToggles) {
+                send(std::string("option name ") + toggle.name + " type check default " + (defaults.*toggle.flag ? "true" : "false"));
+            }
+            for (const SearchTunable &tunable : SearchTunables) {
+                send(std::string("option name ") + tunable.name + " type spin default " + std::to_string(defaults.*tunable.value)
+                     + " min " + std::to_string(tunable.min) + " max " + std::to_string(tunable.max));
+            }
+            send("uciok");
+        } else if (command == "isready") {
+            send("readyok");
+        } else if (command == "setoption") {
+            setOption(engine, multiPV, args);
+        } else if (command == "ucinewgame") {
+            engine.clearHash();
+        } else if (command == "position") {
+            setPosition(pos, args);
+        } else if (command == "go") {
+            SearchLimits limits = parseGo(pos, args);
+            limits.multiPV = multiPV;
+            Stats::reset();
+            engine.go(pos, limits);
+        } else if (command == "ponderhit") {
+            engine.ponderhit();
+        } else if (command == "stop") {
+            engine.stop();
+        } else if (command == "quit") {
+            break;
+        }
+    }
+
+    engine.stop();
+    engine.waitForIdle();
+    return 0;
+}
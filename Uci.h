@@ -0,0 +1,14 @@
+#ifndef CHESS_UCI_H
+#define CHESS_UCI_H
+
+#include "Position.h"
+
+#include <string>
+
+// Legal move in pos written as UCI text (e.g. "e7e8q"), or Move::none()
+Move parseUciMove(const Position &pos, const std::string &text);
+
+// Runs the UCI protocol on stdin/stdout until "quit"; returns the process exit code
+int runUci();
+
+#endif //CHESS_UCI_H
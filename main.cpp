@@ -1,446 +1,269 @@
 #include <QApplication>
-#include <QGraphicsView>
-#include <QGraphicsScene>
-#include <QGraphicsTextItem>
-#include <QBrush>
-#include <QPen>
-#include <QDebug>
-#include <QMouseEvent>
-#include <unordered_map>
-
-enum class PieceType { Pawn, Rook, Knight, Bishop, Queen, King };
-
-class ChessPiece : public QGraphicsTextItem {
-public:
-    static const int Type; // Declaration of the static type identifier for ChessPiece
-
-    ChessPiece(const QString &symbol, int x, int y, PieceType type, bool isWhite)
-            : QGraphicsTextItem(symbol), m_pieceType(type), m_isWhite(isWhite) {
-        setPos(x, y);
-        setDefaultTextColor(isWhite ? Qt::black : Qt::white);
-        setFont(QFont("Arial", 24));
+#include <QFile>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QWidget>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "AnalysisPanel.h"
+#include "BoardGrid.h"
+#include "ClickReplay.h"
+#include "ChessBoard.h"
+#include "GamePanel.h"
+#include "ReplayPanel.h"
+#include "Search.h"
+#include "StatsPanel.h"
+#include "Trace.h"
+#include "Uci.h"
+
+// Times perft on the core position, so copy-make and make/unmake builds can be compared
+static int runPerft(int depth, const char *fen) {
+    Position position;
+    if (fen && !position.setFen(fen)) {
+        std::cerr << "Invalid FEN: " << fen << std::endl;
+        return 1;
     }
 
-    // Returns the chess piece type (e.g., Pawn, Rook, etc.)
-    PieceType pieceType() const { return m_pieceType; }
-    bool isWhitePiece() const { return m_isWhite; }
-
-    void highlight(bool highlight = true) {
-        setOpacity(highlight ? 0.5 : 1.0);
-    }
-
-    // Override the QGraphicsItem::type() method to return our custom type identifier
-    int type() const override {
-        return Type;
-    }
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t nodes = perft(position, depth);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+#ifdef CHESS_COPY_MAKE
+    const char *mode = "copy-make";
+#else
+    const char *mode = "make/unmake";
+#endif
+    std::cout << "perft " << depth << " (" << mode << "): " << nodes << " nodes in " << elapsed << " s, "
+              << static_cast<std::uint64_t>(nodes / std::max(elapsed, 1e-9)) << " nps" << std::endl;
+    return 0;
+}
 
-private:
-    PieceType m_pieceType; // Using m_ prefix for member variables for clarity
-    bool m_isWhite;
+// Fixed positions searched by "bench": openings, middlegames, a pawn ending and tactics
+static const char *const BenchFens[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+    "8/8/4kpp1/3p4/p6P/2B4b/6P1/6K1 w - - 0 1",
 };
 
-// Definition of the static type identifier for ChessPiece
-// This needs to be done in a source file (.cpp), not in the header (.h)
-const int ChessPiece::Type = QGraphicsItem::UserType + 1;
-
-class ChessBoard : public QGraphicsView {
-public:
-    ChessBoard(QWidget *parent = nullptr) : QGraphicsView(parent), selectedPiece(nullptr), isWhiteTurn(false) {
-        scene = new QGraphicsScene(this);
-        setScene(scene);
-        setFixedSize(400, 400);
-        setBackgroundBrush(QBrush(Qt::gray));
-
-        drawBoard();
-        setupPieces();
-    }
-
-protected:
-    void mousePressEvent(QMouseEvent *event) override;
-
-private:
-    void drawBoard();
-    void setupPieces();
-    bool isValidMove(ChessPiece *piece, int row, int col);
-    void highlightValidMoves(ChessPiece *piece, bool highlight = true);
-    bool isValidMoveWhitePawn(ChessPiece *piece, int newRow, int newCol);
-    bool isValidMoveBlackPawn(ChessPiece *piece, int newRow, int newCol);
-    bool isPawnPromotion(ChessPiece *piece, int newRow);
-    void promotePawn(ChessPiece *piece, int newRow, int newCol);
-
-    QGraphicsScene *scene;
-    ChessPiece *selectedPiece;
-    QPointF originalPos;
-    QList<QGraphicsRectItem*> highlightedSquares;
-    bool isWhiteTurn;
-
-    bool movePiece(ChessPiece *piece, int row, int col);
-
-    bool isPathBlocked(int row, int col, int row1, int col1);
-
-    void clearHighlights();
+struct BenchResult {
+    std::uint64_t nodes = 0;
+    double seconds = 0;
 };
 
-void ChessBoard::highlightValidMoves(ChessPiece *piece, bool highlight) {
-    if (!piece) return;
-
-    for (QGraphicsRectItem *highlightedSquare : highlightedSquares) {
-        scene->removeItem(highlightedSquare);
-        delete highlightedSquare;
-    }
-    highlightedSquares.clear();
-
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            if (isValidMove(piece, row, col)) {
-                QGraphicsRectItem *highlightedSquare = new QGraphicsRectItem(col * 50, row * 50, 50, 50);
-                highlightedSquare->setBrush(QBrush(Qt::blue));
-                highlightedSquare->setOpacity(highlight ? 0.5 : 0);
-                scene->addItem(highlightedSquare);
-                highlightedSquares.append(highlightedSquare);
-            }
-        }
-    }
-}
-
-void ChessBoard::mousePressEvent(QMouseEvent *event) {
-    QGraphicsView::mousePressEvent(event);
-
-    QPoint viewportPos = event->pos();
-    QPointF scenePos = mapToScene(viewportPos);
-    qDebug() << "Clicked at scene position: " << scenePos;
-
-    int row = static_cast<int>(scenePos.y() / 50);
-    int col = static_cast<int>(scenePos.x() / 50);
-
-    QGraphicsItem *item = scene->itemAt(scenePos, QTransform());
-    ChessPiece *clickedPiece = dynamic_cast<ChessPiece*>(item);
-
-    if (isWhiteTurn) {
-        // White's turn
-        if (selectedPiece == nullptr && clickedPiece != nullptr && clickedPiece->isWhitePiece()) {
-            selectedPiece = clickedPiece;
-            originalPos = clickedPiece->pos();
-            highlightValidMoves(selectedPiece);
-            selectedPiece->highlight();
-        } else if (selectedPiece != nullptr && clickedPiece == nullptr) {
-            if (movePiece(selectedPiece, row, col)) {
-                selectedPiece->highlight(false);
-                selectedPiece = nullptr;
-                clearHighlights();
-                isWhiteTurn = !isWhiteTurn; // Switch to black's turn
-            } else {
-                // Handle invalid move
-            }
-        } else if (selectedPiece != nullptr && clickedPiece == selectedPiece) {
-            selectedPiece->highlight(false);
-            selectedPiece = nullptr;
-            clearHighlights();
-        } else if (selectedPiece != nullptr && clickedPiece != selectedPiece) {
-            // Handle trying to move opponent's piece
-        } else {
-            // Handle other cases
-        }
-    } else {
-        // Black's turn
-        if (selectedPiece == nullptr && clickedPiece != nullptr && !clickedPiece->isWhitePiece()) {
-            selectedPiece = clickedPiece;
-            originalPos = clickedPiece->pos();
-            highlightValidMoves(selectedPiece);
-            selectedPiece->highlight();
-        } else if (selectedPiece != nullptr && clickedPiece == nullptr) {
-            if (movePiece(selectedPiece, row, col)) {
-                selectedPiece->highlight(false);
-                selectedPiece = nullptr;
-                clearHighlights();
-                isWhiteTurn = !isWhiteTurn; // Switch to white's turn
-            } else {
-                // Handle invalid move
-            }
-        } else if (selectedPiece != nullptr && clickedPiece == selectedPiece) {
-            selectedPiece->highlight(false);
-            selectedPiece = nullptr;
-            clearHighlights();
-        } else if (selectedPiece != nullptr && clickedPiece != selectedPiece) {
-            // Handle trying to move opponent's piece
-        } else {
-            // Handle other cases
-        }
+static BenchResult benchOnce(Engine &engine, const SearchParams &params, int depth) {
+    engine.setParams(params);
+    BenchResult total;
+    std::uint64_t nodes = 0;
+    engine.setInfoCallback([&nodes](const SearchInfo &info) { nodes = info.nodes; });
+
+    for (const char *fen : BenchFens) {
+        Position position;
+        position.setFen(fen);
+        engine.clearHash();
+
+        SearchLimits limits;
+        limits.depth = depth;
+        auto start = std::chrono::steady_clock::now();
+        engine.go(position, limits);
+        engine.waitForIdle();
+        total.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        total.nodes += nodes;
     }
+    return total;
 }
 
-
-void ChessBoard::drawBoard() {
-    for (int i = 0; i < 8; ++i) {
-        for (int j = 0; j < 8; ++j) {
-            QColor color = (i + j) % 2 == 0 ? Qt::lightGray : Qt::darkGray;
-            QGraphicsRectItem *square = new QGraphicsRectItem(j * 50, i * 50, 50, 50);
-            square->setBrush(QBrush(color));
-            scene->addItem(square);
+// Nodes to a fixed depth over the bench positions; "ablate" repeats it with each
+// selectivity technique switched off in turn to show what it saves
+static int runBench(int depth, bool ablate) {
+    Engine engine(1, 16);
+    SearchParams defaults;
+    BenchResult base = benchOnce(engine, defaults, depth);
+
+    auto report = [&base](const char *label, const BenchResult &result) {
+        std::cout << std::left << std::setw(22) << label << std::right << std::setw(12) << result.nodes << " nodes "
+                  << std::fixed << std::setprecision(2) << std::setw(7) << result.seconds << " s "
+                  << std::setw(9) << static_cast<std::uint64_t>(result.nodes / std::max(result.seconds, 1e-9)) << " nps";
+        if (&result != &base) {
+            std::cout << "  " << std::showpos << std::setprecision(1) << 100.0 * (double(result.nodes) / base.nodes - 1) << "% nodes" << std::noshowpos;
         }
+        std::cout << std::endl;
+    };
+
+    std::cout << "bench depth " << depth << ", " << std::size(BenchFens) << " positions" << std::endl;
+    report("all on", base);
+    if (!ablate) return 0;
+
+    for (const SearchToggle &toggle : SearchToggles) {
+        SearchParams params = defaults;
+        params.*toggle.flag = false;
+        std::string label = std::string(toggle.name) + " off";
+        report(label.c_str(), benchOnce(engine, params, depth));
     }
-}
 
-void ChessBoard::setupPieces() {
-    // Setup white pieces
-    scene->addItem(new ChessPiece("♖", 0, 0, PieceType::Rook, true));
-    scene->addItem(new ChessPiece("♖", 350, 0, PieceType::Rook, true));
-    scene->addItem(new ChessPiece("♘", 50, 0, PieceType::Knight, true));
-    scene->addItem(new ChessPiece("♘", 300, 0, PieceType::Knight, true));
-    scene->addItem(new ChessPiece("♗", 100, 0, PieceType::Bishop, true));
-    scene->addItem(new ChessPiece("♗", 250, 0, PieceType::Bishop, true));
-    scene->addItem(new ChessPiece("♕", 150, 0, PieceType::Queen, true));
-    scene->addItem(new ChessPiece("♔", 200, 0, PieceType::King, true));
-    scene->addItem(new ChessPiece("♙", 0, 50, PieceType::Pawn, true));
-    scene->addItem(new ChessPiece("♙", 50, 50, PieceType::Pawn, true));
-    scene->addItem(new ChessPiece("♙", 100, 50, PieceType::Pawn, true));
-    scene->addItem(new ChessPiece("♙", 150, 50, PieceType::Pawn, true));
-    scene->addItem(new ChessPiece("♙", 200, 50, PieceType::Pawn, true));
-    scene->addItem(new ChessPiece("♙", 250, 50, PieceType::Pawn, true));
-    scene->addItem(new ChessPiece("♙", 300, 50, PieceType::Pawn, true));
-    scene->addItem(new ChessPiece("♙", 350, 50, PieceType::Pawn, true));
-
-    // Setup black pieces
-    scene->addItem(new ChessPiece("♜", 0, 350, PieceType::Rook, false));
-    scene->addItem(new ChessPiece("♜", 350, 350, PieceType::Rook, false));
-    scene->addItem(new ChessPiece("♞", 50, 350, PieceType::Knight, false));
-    scene->addItem(new ChessPiece("♞", 300, 350, PieceType::Knight, false));
-    scene->addItem(new ChessPiece("♝", 100, 350, PieceType::Bishop, false));
-    scene->addItem(new ChessPiece("♝", 250, 350, PieceType::Bishop, false));
-    scene->addItem(new ChessPiece("♛", 150, 350, PieceType::Queen, false));
-    scene->addItem(new ChessPiece("♚", 200, 350, PieceType::King, false));
-    scene->addItem(new ChessPiece("♟", 0, 300, PieceType::Pawn, false));
-    scene->addItem(new ChessPiece("♟", 50, 300, PieceType::Pawn, false));
-    scene->addItem(new ChessPiece("♟", 100, 300, PieceType::Pawn, false));
-    scene->addItem(new ChessPiece("♟", 150, 300, PieceType::Pawn, false));
-    scene->addItem(new ChessPiece("♟", 200, 300, PieceType::Pawn, false));
-    scene->addItem(new ChessPiece("♟", 250, 300, PieceType::Pawn, false));
-    scene->addItem(new ChessPiece("♟", 300, 300, PieceType::Pawn, false));
-    scene->addItem(new ChessPiece("♟", 350, 300, PieceType::Pawn, false));
+    SearchParams plain = defaults;
+    for (const SearchToggle &toggle : SearchToggles) plain.*toggle.flag = false;
+    report("all off", benchOnce(engine, plain, depth));
+    return 0;
 }
 
-bool ChessBoard::movePiece(ChessPiece *piece, int row, int col) {
-    if (!piece) return false;
-
-    int currentRow = piece->pos().y() / 50;
-    int currentCol = piece->pos().x() / 50;
-
-    if (isValidMove(piece, row, col)) {
-        // Find all items in the square we're moving to
-        QList<QGraphicsItem *> itemsAtDestination = scene->items(QRectF(col * 50, row * 50, 50, 50), Qt::IntersectsItemShape);
-        for (QGraphicsItem *item : itemsAtDestination) {
-            ChessPiece *potentialCapturedPiece = dynamic_cast<ChessPiece *>(item);
-            if (potentialCapturedPiece && potentialCapturedPiece != piece && potentialCapturedPiece->isWhitePiece() != piece->isWhitePiece()) {
-                qDebug() << "Capturing piece at " << col << ", " << row;
-                scene->removeItem(potentialCapturedPiece);
-                delete potentialCapturedPiece;
-                break; // Assuming only one piece can occupy a square
-            }
+// Engine-vs-engine games, one after another, posting every position to its board
+static void playGridGames(BoardGrid &grid, int board, int moveTimeMs, const std::atomic<bool> &quit) {
+    Engine engine(1, 4);
+    SearchResult result;
+    engine.setBestMoveCallback([&result](const SearchResult &found) { result = found; });
+    std::mt19937 random(board);
+
+    SearchLimits limits;
+    limits.moveTimeMs = moveTimeMs;
+    while (!quit) {
+        // A few random opening moves keep the games apart
+        Position position;
+        for (int ply = 0; ply < 4; ++ply) {
+            MoveList moves;
+            generateLegalMoves(position, moves);
+            position.doMove(moves.moves[random() % moves.size()]);
         }
-
-        // Check for pawn promotion
-        if (isPawnPromotion(piece, row)) {
-            promotePawn(piece, row, col);
-        } else {
-            // Move the piece to the new location
-            piece->setPos(col * 50, row * 50);
+        engine.clearHash();
+        grid.setPosition(board, position);
+
+        while (!quit) {
+            engine.go(position, limits);
+            engine.waitForIdle();
+            if (result.bestMove.isNone() || result.gameResult != GameResult::Ongoing) break;
+            position.doMove(result.bestMove);
+            grid.setPosition(board, position);
         }
 
-        // The move was successful
-        return true;
+        // Leave the final position up for a moment before the next game
+        for (int wait = 0; wait < 20 && !quit; ++wait) std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
-
-    // The move was not successful (invalid move)
-    return false;
 }
 
-bool ChessBoard::isPathBlocked(int startRow, int startCol, int endRow, int endCol) {
-    if (startRow == endRow && startCol == endCol) {
-        return false; // No path to check, start and end are the same.
-    }
-
-    int rowDirection = (endRow > startRow) ? 1 : (endRow < startRow) ? -1 : 0;
-    int colDirection = (endCol > startCol) ? 1 : (endCol < startCol) ? -1 : 0;
-
-    int currentRow = startRow + rowDirection;
-    int currentCol = startCol + colDirection;
-
-    while ((currentRow != endRow || currentCol != endCol)) {
-        QGraphicsItem* item = scene->itemAt(currentCol * 50 + 25, currentRow * 50 + 25, QTransform());
-        if (item) {
-            ChessPiece* chessPiece = dynamic_cast<ChessPiece*>(item);
-            if (chessPiece) {
-                return true; // Found a chess piece blocking the path.
-            }
-        }
-        currentRow += rowDirection;
-        currentCol += colDirection;
+// Shows many concurrent engine games at once, each on its own thread
+static int runGrid(int argc, char *argv[], int boards, int moveTimeMs) {
+    QApplication app(argc, argv);
+    BoardGrid grid(std::max(boards, 1));
+    grid.setWindowTitle("Chess exhibition");
+    grid.resize(1200, 900);
+    grid.show();
+
+    std::atomic<bool> quit{false};
+    std::vector<std::thread> games;
+    for (int board = 0; board < grid.boardCount(); ++board) {
+        games.emplace_back(playGridGames, std::ref(grid), board, moveTimeMs, std::cref(quit));
     }
 
-    return false; // Path is not blocked.
+    int result = app.exec();
+    quit = true;
+    for (std::thread &game : games) game.join();
+    return result;
 }
 
-
-
-bool ChessBoard::isValidMoveWhitePawn(ChessPiece *piece, int newRow, int newCol) {
-    if (!piece) return false;
-
-    int currentRow = piece->pos().y() / 50;
-    int currentCol = piece->pos().x() / 50;
-    int rowDiff = newRow - currentRow;
-    int colDiff = newCol - currentCol;
-
-    QGraphicsItem *destinationItem = scene->itemAt(newCol * 50 + 25, newRow * 50 + 25, QTransform());
-    ChessPiece *destinationPiece = dynamic_cast<ChessPiece *>(destinationItem);
-
-    // Forward movement without capture
-    if (colDiff == 0 && !destinationPiece) {
-        if (rowDiff == 1) {
-            return true; // Move one square forward
-        }
-        if (rowDiff == 2 && currentRow == 6 && !isPathBlocked(currentRow, currentCol, newRow, newCol)) {
-            return true; // Initial double move
-        }
+// Writes the trace when main returns, after the windows and engines are gone
+struct TraceDump {
+    const char *path;
+    ~TraceDump() {
+        if (path && !Trace::writeChromeJson(path)) std::cerr << "Could not write trace to " << path << std::endl;
     }
+};
 
-    // Capture move
-    if (abs(colDiff) == 1 && rowDiff == -1) { // White pawn moves up the board, hence -1
-        QGraphicsItem *destinationItem = scene->itemAt(newCol * 50 + 25, newRow * 50 + 25, QTransform());
-        ChessPiece *destinationPiece = dynamic_cast<ChessPiece *>(destinationItem);
-        if (destinationPiece && destinationPiece->isWhitePiece() != piece->isWhitePiece()) {
-            return true; // There's a piece of the opposite color, capture is valid
-        }
+int main(int argc, char *argv[]) {
+    Bitboards::init();
+    Position::init();
+
+    // CHESS_TRACE=<file> records a timeline of every thread and writes it there on exit
+    TraceDump traceDump{std::getenv("CHESS_TRACE")};
+    if (traceDump.path) {
+        Trace::setEnabled(true);
+        Trace::setThreadName("main");
     }
 
-    return false;
-}
-
-bool ChessBoard::isValidMoveBlackPawn(ChessPiece *piece, int newRow, int newCol) {
-    if (!piece) return false;
-
-    int currentRow = piece->pos().y() / 50;
-    int currentCol = piece->pos().x() / 50;
-    int rowDiff = newRow - currentRow;
-    int colDiff = newCol - currentCol;
-
-    QGraphicsItem *destinationItem = scene->itemAt(newCol * 50 + 25, newRow * 50 + 25, QTransform());
-    ChessPiece *destinationPiece = dynamic_cast<ChessPiece *>(destinationItem);
-
-    // Forward movement without capture
-    if (colDiff == 0 && !destinationPiece) {
-        if (rowDiff == -1) {
-            return true; // Move one square forward
-        }
-        if (rowDiff == -2 && currentRow == 1 && !isPathBlocked(currentRow, currentCol, newRow, newCol)) {
-            return true; // Initial double move
-        }
+    // "Chess perft <depth> [fen]" runs the benchmark without opening a window
+    if (argc > 2 && std::strcmp(argv[1], "perft") == 0) {
+        return runPerft(std::atoi(argv[2]), argc > 3 ? argv[3] : nullptr);
     }
 
-    // Capture move
-    if (abs(colDiff) == 1 && rowDiff == 1 && destinationPiece && destinationPiece->isWhitePiece() != piece->isWhitePiece()) {
-        return true; // Diagonal capture
+    // "Chess bench [depth] [ablate]" reports nodes and speed for a fixed set of positions
+    if (argc > 1 && std::strcmp(argv[1], "bench") == 0) {
+        return runBench(argc > 2 ? std::atoi(argv[2]) : 8, argc > 3 && std::strcmp(argv[3], "ablate") == 0);
     }
 
-    return false;
-}
-
-
-
-bool ChessBoard::isValidMove(ChessPiece *piece, int newRow, int newCol) {
-    if (!piece) return false;
-
-    int currentRow = piece->pos().y() / 50;
-    int currentCol = piece->pos().x() / 50;
-
-    // Check if the destination is the same as the current position
-    if (newRow == currentRow && newCol == currentCol) {
-        // The piece is not actually moving
-        return false;
+    // "Chess uci" speaks UCI on stdin/stdout, so the engine can play in other GUIs
+    if (argc > 1 && std::strcmp(argv[1], "uci") == 0) {
+        return runUci();
     }
 
-    int rowDiff = newRow - currentRow;
-    int colDiff = newCol - currentCol;
-    int absRowDiff = std::abs(rowDiff);
-    int absColDiff = std::abs(colDiff);
-
-    QGraphicsItem *destinationItem = scene->itemAt(newCol * 50 + 25, newRow * 50 + 25, QTransform());
-    ChessPiece *destinationPiece = dynamic_cast<ChessPiece *>(destinationItem);
-    // Ensure a piece doesn't capture one of the same color
-    if (destinationPiece && destinationPiece->isWhitePiece() == piece->isWhitePiece()) {
-        return false;
+    // "Chess latency <clicks file> [repeats] [p99 budget us]" replays recorded clicks headless
+    if (argc > 2 && std::strcmp(argv[1], "latency") == 0) {
+        return runLatencyHarness(argc, argv, argv[2], argc > 3 ? std::atoi(argv[3]) : 1, argc > 4 ? std::atof(argv[4]) : 0);
     }
 
-    switch (piece->pieceType()) {
-        case PieceType::Pawn:
-            // Pawn move logic is handled in the respective functions
-            return piece->isWhitePiece() ? isValidMoveWhitePawn(piece, newRow, newCol) : isValidMoveBlackPawn(piece, newRow, newCol);
-
-        case PieceType::Rook: {
-            // Check if moving straight in a row or column
-            if (newRow != currentRow && newCol != currentCol) return false; // Not moving straight
-
-            // Check for path blockage for moves longer than one square
-            if ((rowDiff > 1 || colDiff > 1) && isPathBlocked(currentRow, currentCol, newRow, newCol)) return false;
-
-            return true; // Rook can move if no blockage and moving straight
-        }
-
-        case PieceType::Knight:
-            // Knights can jump over pieces
-            if ((absRowDiff == 2 && absColDiff == 1) || (absRowDiff == 1 && absColDiff == 2)) return true;
-            break;
-
-        case PieceType::Bishop:
-            // Bishops move diagonally and cannot jump over pieces
-            if (absRowDiff == absColDiff && !isPathBlocked(currentRow, currentCol, newRow, newCol)) return true;
-            break;
-
-        case PieceType::Queen:
-            // Queens move horizontally, vertically, or diagonally and cannot jump over pieces
-            if ((absRowDiff == absColDiff || rowDiff == 0 || colDiff == 0) && !isPathBlocked(currentRow, currentCol, newRow, newCol)) return true;
-            break;
-
-        case PieceType::King:
-            // Kings move one square in any direction and cannot jump over pieces (though this is implicit in the one-square move)
-            if (absRowDiff <= 1 && absColDiff <= 1 && (absRowDiff + absColDiff > 0) && !isPathBlocked(currentRow, currentCol, newRow, newCol)) return true;
-            break;
-
-        default:
-            return false;
+    // "Chess guibench <clicks file> [repeats]" measures GUI event throughput headless
+    if (argc > 2 && std::strcmp(argv[1], "guibench") == 0) {
+        return runClickBench(argc, argv, argv[2], argc > 3 ? std::atoi(argv[3]) : 100);
     }
-    return false;
-}
 
-
-bool ChessBoard::isPawnPromotion(ChessPiece *piece, int newRow) {
-    if (piece->pieceType() == PieceType::Pawn && (newRow == 0 || newRow == 7)) {
-        return true;
+    // "Chess grid [boards] [movetime ms]" plays that many engine games side by side
+    if (argc > 1 && std::strcmp(argv[1], "grid") == 0) {
+        return runGrid(argc, argv, argc > 2 ? std::atoi(argv[2]) : 16, argc > 3 ? std::atoi(argv[3]) : 200);
     }
-    return false;
-}
 
-void ChessBoard::promotePawn(ChessPiece *piece, int newRow, int newCol) {
-    // Replace pawn with a queen
-    bool isWhite = piece->isWhitePiece();
-    scene->removeItem(piece);
-    delete piece;
-    scene->addItem(new ChessPiece("♕", newCol * 50, newRow * 50, PieceType::Queen, isWhite));
-}
+    QApplication app(argc, argv);
 
-void ChessBoard::clearHighlights() {
-    for (auto *highlightedSquare : qAsConst(highlightedSquares)) {
-        scene->removeItem(highlightedSquare);
-        delete highlightedSquare;
+    QWidget window;
+    QHBoxLayout *layout = new QHBoxLayout(&window);
+    ChessBoard *chessBoard = new ChessBoard;
+    GamePanel *gamePanel = new GamePanel(chessBoard);
+    ReplayPanel *replayPanel = new ReplayPanel(chessBoard);
+    AnalysisPanel *analysisPanel = new AnalysisPanel;
+    QVBoxLayout *sideLayout = new QVBoxLayout;
+    sideLayout->addWidget(gamePanel);
+    sideLayout->addWidget(replayPanel);
+    sideLayout->addWidget(analysisPanel, 1);
+#ifdef CHESS_STATS
+    sideLayout->addWidget(new StatsPanel);
+#endif
+    layout->addWidget(chessBoard);
+    layout->addLayout(sideLayout);
+
+    // Every move hands the turn to the engine if it plays that side, and restarts the analysis
+    QObject::connect(chessBoard, &ChessBoard::positionChanged, gamePanel, &GamePanel::setPosition);
+    QObject::connect(chessBoard, &ChessBoard::positionChanged, analysisPanel, &AnalysisPanel::setPosition);
+    QObject::connect(replayPanel, &ReplayPanel::jumped, gamePanel, &GamePanel::resume);
+    QObject::connect(analysisPanel, &AnalysisPanel::bestMovesChanged, chessBoard, &ChessBoard::setMoveMarks);
+    analysisPanel->setPosition(chessBoard->currentPosition());
+
+    // CHESS_RECORD_CLICKS=<file> saves the session's clicks for the latency harness
+    QFile clickLog(qEnvironmentVariable("CHESS_RECORD_CLICKS"));
+    if (!clickLog.fileName().isEmpty() && clickLog.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)) {
+        QObject::connect(chessBoard, &ChessBoard::pressed, [&clickLog](const QPointF &scenePos) {
+            clickLog.write(QString("%1 %2\n").arg(scenePos.x()).arg(scenePos.y()).toUtf8());
+            clickLog.flush();
+        });
     }
-    highlightedSquares.clear();
-}
 
+    window.show();
 
-int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
+    int result = app.exec();
 
-    ChessBoard chessBoard;
-    chessBoard.show();
-
-    return app.exec();
+    // CHESS_LATENCY=1 prints the GUI latency percentiles of the session on exit
+    if (qEnvironmentVariableIsSet("CHESS_LATENCY")) {
+        std::cerr << chessBoard->clickLatency().summary("click to highlight") << '\n'
+                  << chessBoard->moveLatency().summary("move to scene") << std::endl;
+    }
+    return result;
 }